@@ -1,6 +1,9 @@
 #include "ARP.h"
 #include "Ethernet.h"
 #include "helper.h"
+#include <string.h>
+#include <time.h>
+#include "clock.h"
 
 typedef struct
 {
@@ -33,6 +36,28 @@ typedef struct
 
 static ARP_TableEntry ARP_Table[10] = {{0}};
 
+// Frames whose next hop is not resolved yet, one per slot. They are sent as soon as the ARP reply arrives.
+typedef struct
+{
+	IP_Hostpart_t	IP;		// Next hop, 0 = slot unused
+	uint8_t		tries;		// Unanswered ARP requests for this next hop, the same in all its slots
+	time_t		expires;	// Last ARP request + ARP_HOLD_TIMEOUT, the slot is free again afterwards
+	bool		resolved;	// ARP reply arrived, frame is ready to send
+	uint16_t	length;
+	uint8_t		frame[ARP_HOLD_LEN];
+} ARP_HoldEntry;
+
+static ARP_HoldEntry ARP_Hold[ARP_HOLD_SLOTS];
+
+// Negative cache: hosts which did not answer ARP_MAX_TRIES requests
+typedef struct
+{
+	IP_Hostpart_t	IP;
+	time_t		timeout;
+} ATTR_PACKED ARP_UnreachableEntry;
+
+static ARP_UnreachableEntry ARP_Unreachable[ARP_HOLD_SLOTS];
+
 static uint8_t ARP_WriteHeader(uint8_t packet[], ARP_Operation_t operation, const MAC_Address_t *destinationMAC, const IP_Address_t *destinationIP)
 {
 	ARP_Header_t *ARP = (ARP_Header_t *)packet;
@@ -88,6 +113,21 @@ bool ARP_ProcessPacket(uint8_t packet[], uint16_t length)
 				else
 					writePosition = 0;
 			}
+
+			for(uint8_t i = 0; i < ARRAY_SIZE(ARP_Unreachable); i++)
+				if(ARP_Unreachable[i].IP == IP_Hostpart)
+					ARP_Unreachable[i].IP = 0;
+
+			// Release parked frames for this host, ARP_GetHeldFrame sends them
+			for(uint8_t i = 0; i < ARRAY_SIZE(ARP_Hold); i++)
+			{
+				if(ARP_Hold[i].IP == IP_Hostpart && !ARP_Hold[i].resolved && clock_getUptime() < ARP_Hold[i].expires)
+				{
+					MAC_Address_t *destinationMAC = (MAC_Address_t *)ARP_Hold[i].frame;
+					*destinationMAC = ARP->SenderMAC;
+					ARP_Hold[i].resolved = true;
+				}
+			}
 			return false;
 		default:
 			return false;
@@ -107,9 +147,91 @@ const MAC_Address_t* ARP_searchMAC(const IP_Address_t *IP)
 	return retVal;
 }
 
-uint8_t ARP_GenerateRequest(uint8_t packet[], const IP_Address_t *destinationIP)
+uint16_t ARP_GenerateRequest(uint8_t packet[], const IP_Address_t *destinationIP)
 {
-	uint8_t offset = Ethernet_GenerateBroadcast(packet, CPU_TO_BE16(ETHERTYPE_ARP));
+	uint8_t length = ARP_WriteHeader(packet + ETHERNET_HEADER_LEN, CPU_TO_BE16(ARP_OPERATION_REQUEST), &BroadcastMACAddress, destinationIP);
+
+	return Ethernet_GenerateBroadcast(packet, CPU_TO_BE16(ETHERTYPE_ARP), length);
+}
+
+uint16_t ARP_HoldFrame(uint8_t packet[], uint16_t length, const IP_Address_t *nextHop)
+{
+	const IP_Address_t nextHopCopy = *nextHop;	// Could point into packet, which gets overwritten by the ARP request
+	const IP_Hostpart_t IP_Hostpart = IP_getHost(&nextHopCopy);
+	time_t now = clock_getUptime();
+
+	for(uint8_t i = 0; i < ARRAY_SIZE(ARP_Unreachable); i++)
+		if(ARP_Unreachable[i].IP == IP_Hostpart && now < ARP_Unreachable[i].timeout)
+			return 0;	// Don't ARP unreachable hosts, drop frame
+
+	// Every frame gets its own slot, so frames to several servers behind the router don't replace each other.
+	// Take a free or expired slot. Expired slots of this host still count its tries, unless they are long ago.
+	ARP_HoldEntry *slot = NULL;
+	uint8_t tries = 0;
+	bool requested = false;
+	for(uint8_t i = 0; i < ARRAY_SIZE(ARP_Hold); i++)
+	{
+		ARP_HoldEntry *entry = &ARP_Hold[i];
+		if(entry->IP == IP_Hostpart && !entry->resolved && now < entry->expires + ARP_NEGATIVE_TIMEOUT)
+		{
+			tries = MAX(tries, entry->tries);
+			requested |= entry->expires == now + ARP_HOLD_TIMEOUT;
+		}
+		if(!slot && (!entry->IP || (!entry->resolved && now >= entry->expires)))
+			slot = entry;
+	}
+
+	// Several frames in the same second count as one try
+	if(!requested && ++tries > ARP_MAX_TRIES)
+	{	// Host did not answer, remember it in the negative cache
+		static uint8_t writePosition = 0;
+		ARP_Unreachable[writePosition].IP = IP_Hostpart;
+		ARP_Unreachable[writePosition].timeout = now + ARP_NEGATIVE_TIMEOUT;
+		if(++writePosition >= ARRAY_SIZE(ARP_Unreachable))
+			writePosition = 0;
+
+		for(uint8_t i = 0; i < ARRAY_SIZE(ARP_Hold); i++)
+			if(ARP_Hold[i].IP == IP_Hostpart && !ARP_Hold[i].resolved)
+				ARP_Hold[i].IP = 0;
+		return 0;
+	}
 
-	return offset + ARP_WriteHeader(packet + offset, CPU_TO_BE16(ARP_OPERATION_REQUEST), &BroadcastMACAddress, destinationIP);
+	if(slot && length <= sizeof(slot->frame))
+	{
+		slot->IP = IP_Hostpart;
+		slot->resolved = false;
+		slot->expires = now + ARP_HOLD_TIMEOUT;
+		slot->length = length;
+		memcpy(slot->frame, packet, length);
+	}
+	// Frames still waiting for this host wait for the new request, too. Expired ones only keep the count.
+	for(uint8_t i = 0; i < ARRAY_SIZE(ARP_Hold); i++)
+	{
+		if(ARP_Hold[i].IP == IP_Hostpart && !ARP_Hold[i].resolved)
+		{
+			ARP_Hold[i].tries = tries;
+			if(now < ARP_Hold[i].expires)
+				ARP_Hold[i].expires = now + ARP_HOLD_TIMEOUT;
+		}
+	}
+	// else: No free slot or longer than ARP_HOLD_LEN, the frame is lost.
+	// The ARP request is sent anyway, so the next frame finds the MAC.
+
+	return ARP_GenerateRequest(packet, &nextHopCopy);
+}
+
+uint16_t ARP_GetHeldFrame(uint8_t packet[])
+{
+	for(uint8_t i = 0; i < ARRAY_SIZE(ARP_Hold); i++)
+	{
+		if(ARP_Hold[i].resolved)
+		{
+			uint16_t length = ARP_Hold[i].length;
+			memcpy(packet, ARP_Hold[i].frame, length);
+			ARP_Hold[i].IP = 0;
+			ARP_Hold[i].resolved = false;
+			return length;
+		}
+	}
+	return 0;
 }
@@ -5,7 +5,14 @@
 
 bool ARP_ProcessPacket(uint8_t packet[], uint16_t length) ATTR_WARN_UNUSED_RESULT ATTR_NON_NULL_PTR_ARG(1);
 const MAC_Address_t* ARP_searchMAC(const IP_Address_t *IP) ATTR_WARN_UNUSED_RESULT ATTR_NON_NULL_PTR_ARG(1);
-uint8_t ARP_GenerateRequest(uint8_t packet[], const IP_Address_t *destinationIP) ATTR_WARN_UNUSED_RESULT ATTR_NON_NULL_PTR_ARG(1, 2);
+uint16_t ARP_GenerateRequest(uint8_t packet[], const IP_Address_t *destinationIP) ATTR_WARN_UNUSED_RESULT ATTR_NON_NULL_PTR_ARG(1, 2);
+
+// Park a complete frame with unresolved destination MAC and replace it by an ARP request for nextHop.
+// Returns length of the ARP request or 0 if the next hop is known to be unreachable.
+// Only frames up to ARP_HOLD_LEN are parked, longer ones are dropped.
+uint16_t ARP_HoldFrame(uint8_t packet[], uint16_t length, const IP_Address_t *nextHop) ATTR_WARN_UNUSED_RESULT ATTR_NON_NULL_PTR_ARG(1, 3);
+// Copy a parked frame, whose next hop got resolved, into packet. Returns its length or 0.
+uint16_t ARP_GetHeldFrame(uint8_t packet[]) ATTR_WARN_UNUSED_RESULT ATTR_NON_NULL_PTR_ARG(1);
 
 #endif
 
@@ -9,6 +9,7 @@ typedef struct
 	uint16_t	EtherType;
 	uint8_t		data[];
 }  __attribute__((packed, may_alias)) Ethernet_Header_t;
+_Static_assert(sizeof(Ethernet_Header_t) == ETHERNET_HEADER_LEN, "ETHERNET_HEADER_LEN is wrong");
 
 bool Ethernet_ProcessPacket(Packet_t *packet)
 {
@@ -49,18 +50,28 @@ static uint8_t Ethernet_WriteHeader(uint8_t packet[], const MAC_Address_t *desti
 	return sizeof(Ethernet_Header_t);
 }
 
-int8_t Ethernet_GenerateUnicast(uint8_t packet[], const IP_Address_t *destinationIP, Ethertype_t ethertype)
+uint16_t Ethernet_GenerateUnicast(uint8_t packet[], const IP_Address_t *destinationIP, Ethertype_t ethertype, uint16_t payloadLength)
 {
 	const MAC_Address_t *MAC = ARP_searchMAC(destinationIP);
 	if(MAC != NULL)
-	{
-		return Ethernet_WriteHeader(packet, MAC, ethertype);
-	} else {
-		return -ARP_GenerateRequest(packet, destinationIP);
-	}
+		return Ethernet_WriteHeader(packet, MAC, ethertype) + payloadLength;
+
+	// Park the finished frame until the destination MAC is known, send an ARP request instead
+	static const MAC_Address_t unresolvedMAC = {{0}};
+	uint16_t length = Ethernet_WriteHeader(packet, &unresolvedMAC, ethertype) + payloadLength;
+	return ARP_HoldFrame(packet, length, destinationIP);
 }
 
-uint8_t Ethernet_GenerateBroadcast(uint8_t packet[], Ethertype_t ethertype)
+uint16_t Ethernet_GenerateBroadcast(uint8_t packet[], Ethertype_t ethertype, uint16_t payloadLength)
 {
-	return Ethernet_WriteHeader(packet, &BroadcastMACAddress, ethertype);
+	return Ethernet_WriteHeader(packet, &BroadcastMACAddress, ethertype) + payloadLength;
+}
+
+uint16_t Ethernet_GenerateMulticast(uint8_t packet[], const IP_Address_t *groupIP, Ethertype_t ethertype, uint16_t payloadLength)
+{
+	// 01:00:5E followed by the lower 23 bits of the group address
+	const uint8_t *group = (const uint8_t *)groupIP;
+	const MAC_Address_t MAC = {{0x01, 0x00, 0x5E, group[1] & 0x7F, group[2], group[3]}};
+
+	return Ethernet_WriteHeader(packet, &MAC, ethertype) + payloadLength;
 }
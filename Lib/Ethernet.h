@@ -3,6 +3,8 @@
 #include <stdint.h>
 #include "resources.h"
 
+#define ETHERNET_HEADER_LEN	14
+
 typedef enum
 {
 	ETHERTYPE_IPV4 = 0x0800,
@@ -10,8 +12,11 @@ typedef enum
 } Ethertype_t;
 
 bool Ethernet_ProcessPacket(uint8_t packet[], uint16_t length) ATTR_WARN_UNUSED_RESULT ATTR_NON_NULL_PTR_ARG(1);
-int8_t Ethernet_GenerateUnicast(uint8_t packet[], const IP_Address_t *destinationIP, Ethertype_t ethertype) ATTR_WARN_UNUSED_RESULT ATTR_NON_NULL_PTR_ARG(1, 2);
-uint8_t Ethernet_GenerateBroadcast(uint8_t packet[], Ethertype_t ethertype) ATTR_WARN_UNUSED_RESULT ATTR_NON_NULL_PTR_ARG(1);
+// Frames are built back to front: the payload starts at packet + ETHERNET_HEADER_LEN and
+// has to be in place already. Returns the length of the frame to send.
+uint16_t Ethernet_GenerateUnicast(uint8_t packet[], const IP_Address_t *destinationIP, Ethertype_t ethertype, uint16_t payloadLength) ATTR_WARN_UNUSED_RESULT ATTR_NON_NULL_PTR_ARG(1, 2);
+uint16_t Ethernet_GenerateBroadcast(uint8_t packet[], Ethertype_t ethertype, uint16_t payloadLength) ATTR_WARN_UNUSED_RESULT ATTR_NON_NULL_PTR_ARG(1);
+uint16_t Ethernet_GenerateMulticast(uint8_t packet[], const IP_Address_t *groupIP, Ethertype_t ethertype, uint16_t payloadLength) ATTR_WARN_UNUSED_RESULT ATTR_NON_NULL_PTR_ARG(1, 2);
 
 extern const MAC_Address_t BroadcastMACAddress;
 
@@ -0,0 +1,76 @@
+#include "IGMP.h"
+#include "IP.h"
+#include <stdlib.h>
+#include <time.h>
+#include "clock.h"
+
+#ifdef IP_MULTICAST
+
+typedef struct
+{
+	uint8_t		Type;
+	uint8_t		MaxResponseTime;	// 1/10 seconds
+	uint16_t	Checksum;
+	IP_Address_t	GroupAddress;
+} ATTR_PACKED IGMP_Header_t;
+
+typedef enum {
+	IGMP_MembershipQuery = 0x11,
+	IGMP_MembershipReportV1 = 0x12,
+	IGMP_MembershipReportV2 = 0x16,
+} IGMP_Type_t;
+
+#define IGMP_UNSOLICITED_REPORTS	2
+#define IGMP_UNSOLICITED_INTERVAL	10	// Seconds
+#define IGMP_V1_RESPONSE_TIME		100	// 1/10 seconds
+
+// Join the group right after startup
+static time_t IGMP_nextReport = 1;
+static uint8_t IGMP_unsolicitedReports = IGMP_UNSOLICITED_REPORTS;
+
+bool IGMP_ProcessPacket(uint8_t packet[], uint16_t length)
+{
+	IGMP_Header_t *IGMP = (IGMP_Header_t *)packet;
+
+	if(length < sizeof(IGMP_Header_t) || IGMP->Type != IGMP_MembershipQuery)
+		return false;
+
+	// General query or query for our group
+	if(IGMP->GroupAddress != 0 && IGMP->GroupAddress != MulticastIPAddress)
+		return false;
+
+	// Answer after a random delay up to the maximum response time, unless a report is due earlier
+	uint8_t maxResponseTime = IGMP->MaxResponseTime ? : IGMP_V1_RESPONSE_TIME;
+	time_t reportTime = clock_getUptime() + (uint8_t)rand() % DIV_ROUND_UP(maxResponseTime, 10);
+	if(reportTime < IGMP_nextReport)
+		IGMP_nextReport = reportTime;
+
+	return false;
+}
+
+time_t IGMP_NextReport(void)
+{
+	return IGMP_nextReport;
+}
+
+uint16_t IGMP_GenerateReport(uint8_t packet[])
+{
+	time_t now = clock_getUptime();
+	if(now < IGMP_nextReport)
+		return 0;
+
+	if(IGMP_unsolicitedReports && --IGMP_unsolicitedReports)
+		IGMP_nextReport = now + IGMP_UNSOLICITED_INTERVAL;
+	else
+		IGMP_nextReport = UINT32_MAX;	// Wait for the next query
+
+	IGMP_Header_t *IGMP = (IGMP_Header_t *)(packet + IP_PAYLOAD_OFFSET);
+	IGMP->Type		= IGMP_MembershipReportV2;
+	IGMP->MaxResponseTime	= 0;
+	IGMP->GroupAddress	= MulticastIPAddress;
+	IGMP->Checksum		= 0;
+	IGMP->Checksum		= IP_Checksum(IGMP, sizeof(IGMP_Header_t));
+
+	return IP_GenerateMulticast(packet, IP_PROTOCOL_IGMP, sizeof(IGMP_Header_t));
+}
+#endif
@@ -0,0 +1,13 @@
+#ifndef _IGMP_H_
+#define _IGMP_H_
+#include <stdint.h>
+#include <time.h>
+#include "resources.h"
+
+bool IGMP_ProcessPacket(uint8_t packet[], uint16_t length) ATTR_WARN_UNUSED_RESULT ATTR_NON_NULL_PTR_ARG(1);
+// Monotonic second the next report is due, UINT32_MAX if none
+time_t IGMP_NextReport(void) ATTR_WARN_UNUSED_RESULT;
+// Generates a membership report for MulticastIPAddress if one is due. Returns its length or 0.
+uint16_t IGMP_GenerateReport(uint8_t packet[]) ATTR_WARN_UNUSED_RESULT ATTR_NON_NULL_PTR_ARG(1);
+
+#endif
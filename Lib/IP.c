@@ -1,10 +1,12 @@
 #include "IP.h"
 #include "UDP.h"
 #include "ICMP.h"
+#include "IGMP.h"
 #include "Ethernet.h"
 
 #define IP_VERSION_IHL			(0x40 | sizeof(IP_Header_t)/4)
 #define DEFAULT_TTL			64
+#define MULTICAST_TTL			1
 #define IP_FLAGS_DONTFRAGMENT		0x4000
 
 typedef struct
@@ -25,6 +27,11 @@ typedef struct
 
 	uint8_t		data[];
 } ATTR_PACKED IP_Header_t;
+_Static_assert(sizeof(IP_Header_t) == IP_HEADER_LEN, "IP_HEADER_LEN is wrong");
+_Static_assert(PACKET_LEN_MAX - ETHERNET_HEADER_LEN <= UINT16_MAX, "IP length field too small");
+
+// Checksums are calculated over headers and addresses of any type
+typedef uint16_t __attribute__((may_alias)) IP_Word_t;
 
 void IP_ChecksumAdd(uint16_t *checksum, uint16_t word)
 {
@@ -33,19 +40,56 @@ void IP_ChecksumAdd(uint16_t *checksum, uint16_t word)
        if(*checksum < word)
                (*checksum)++;
 #else
-       if(__builtin_uadd_overflow(*checksum, word, checksum))
+       if(__builtin_add_overflow(*checksum, word, checksum))
                (*checksum)++;
 #endif
 }
 
+#ifdef __AVR_ARCH__
+// Add 1 to 255 words to sum with a single add-with-carry chain, 9 cycles per word
+static inline uint16_t IP_ChecksumWords(const IP_Word_t **Words, uint8_t count, uint16_t sum)
+{
+	__asm__ (
+		"	clc			\n"
+		"1:	ld	__tmp_reg__, %a1+	\n"
+		"	adc	%A0, __tmp_reg__	\n"
+		"	ld	__tmp_reg__, %a1+	\n"
+		"	adc	%B0, __tmp_reg__	\n"
+		"	dec	%2		\n"	// dec leaves the carry flag alone
+		"	brne	1b		\n"
+		"	adc	%A0, __zero_reg__	\n"	// End around carry
+		"	adc	%B0, __zero_reg__	\n"
+		"	adc	%A0, __zero_reg__	\n"
+		: "+r" (sum), "+e" (*Words), "+r" (count)
+		:
+		: "memory"
+	);
+	return sum;
+}
+#endif
+
 uint16_t IP_Checksum(const void *data, uint16_t length)
 {
-	const uint16_t *Words = (const uint16_t *)data;
+	const IP_Word_t *Words = (const IP_Word_t *)data;
 	uint16_t length16 = length / 2;
-	uint16_t Checksum = 0;
 
+#ifdef __AVR_ARCH__
+	uint16_t Checksum = 0;
+	while(length16)
+	{
+		uint8_t count = (length16 > UINT8_MAX) ? UINT8_MAX : length16;
+		Checksum = IP_ChecksumWords(&Words, count, Checksum);
+		length16 -= count;
+	}
+#else
+	// Accumulate in 32 bit and fold the carries only once
+	uint32_t Sum = 0;
 	while(length16--)
-		IP_ChecksumAdd(&Checksum, *(Words++));
+		Sum += *(Words++);
+
+	Sum = (Sum & 0xFFFF) + (Sum >> 16);
+	uint16_t Checksum = (Sum & 0xFFFF) + (Sum >> 16);
+#endif
 
 	if(length & 1)
 		IP_ChecksumAdd(&Checksum, *Words & CPU_TO_BE16(0xFF00));
@@ -53,7 +97,16 @@ uint16_t IP_Checksum(const void *data, uint16_t length)
 	return ~Checksum;
 }
 
-static uint8_t IP_WriteHeader(uint8_t packet[], IP_Protocol_t protocol, const IP_Address_t *destinationIP, uint16_t payloadLength)
+void IP_ChecksumUpdate(uint16_t *checksum, uint16_t oldSum, uint16_t newSum)
+{
+	// RFC 1624, Eqn. 3: HC' = ~(~HC + ~m + m')
+	uint16_t sum = ~*checksum;
+	IP_ChecksumAdd(&sum, ~oldSum);
+	IP_ChecksumAdd(&sum, newSum);
+	*checksum = ~sum;
+}
+
+static uint8_t IP_WriteHeader(uint8_t packet[], IP_Protocol_t protocol, const IP_Address_t *destinationIP, uint16_t payloadLength, uint8_t TTL)
 {
 	IP_Header_t *IP = (IP_Header_t *)packet;
 
@@ -62,7 +115,7 @@ static uint8_t IP_WriteHeader(uint8_t packet[], IP_Protocol_t protocol, const IP
 	IP->Length		= cpu_to_be16(sizeof(IP_Header_t) + payloadLength);
 	IP->Identification	= 0;
 	IP->FlagsFragment	= CPU_TO_BE16(IP_FLAGS_DONTFRAGMENT);
-	IP->TTL			= DEFAULT_TTL;
+	IP->TTL			= TTL;
 	IP->Protocol		= protocol;
 	IP->DestinationAddress	= *destinationIP;	// Can be an alias of IP->SourceAddress
 	IP->SourceAddress	= OwnIPAddress;
@@ -85,7 +138,11 @@ bool IP_ProcessPacket(uint8_t packet[], uint16_t length)
 	   ip_length > length))
 		return false;
 
-	if(IP->DestinationAddress != OwnIPAddress && IP->DestinationAddress != BroadcastIPAddress)
+	if(IP->DestinationAddress != OwnIPAddress && IP->DestinationAddress != BroadcastIPAddress
+#ifdef IP_MULTICAST
+	   && IP->DestinationAddress != MulticastIPAddress && IP->DestinationAddress != AllHostsIPAddress
+#endif
+	  )
 		return false;
 
 	length = ip_length - sizeof(IP_Header_t);
@@ -98,35 +155,62 @@ bool IP_ProcessPacket(uint8_t packet[], uint16_t length)
 		case IP_PROTOCOL_UDP:
 			reflect = UDP_ProcessPacket(IP->data, &IP->SourceAddress, length);
 			break;
+#ifdef IP_MULTICAST
+		case IP_PROTOCOL_IGMP:
+			reflect = IGMP_ProcessPacket(IP->data, length);
+			break;
+#endif
 		default:
 			return false;
 	}
 
-	if(reflect)	// rewrite Header, replace destination with sourceAddress
+	if(reflect)	// Replace destination with sourceAddress, length and all other fields stay the same
 	{
-		IP_WriteHeader(packet, IP->Protocol, &IP->SourceAddress, length);
+		const IP_Address_t destinationAddress = IP->DestinationAddress;
+		IP->DestinationAddress	= IP->SourceAddress;
+		IP->SourceAddress	= OwnIPAddress;
+
+		// Swapping both addresses keeps the checksum, only a broadcast destination is replaced
+		if(destinationAddress != OwnIPAddress)
+		{
+			uint16_t oldSum = ~IP_Checksum(&destinationAddress, sizeof(IP_Address_t));
+			uint16_t newSum = ~IP_Checksum(&OwnIPAddress, sizeof(IP_Address_t));
+			IP_ChecksumUpdate(&IP->Checksum, oldSum, newSum);
+			// UDP checksum covers the addresses as part of the pseudo header
+			if(IP->Protocol == IP_PROTOCOL_UDP)
+				UDP_ChecksumUpdate(IP->data, oldSum, newSum);
+		}
+
+		// TTL shares a 16 bit word with Protocol
+		uint16_t *TTL_Protocol = (uint16_t *)&IP->TTL;
+		uint16_t oldWord = *TTL_Protocol;
+		IP->TTL = DEFAULT_TTL;
+		IP_ChecksumUpdate(&IP->Checksum, oldWord, *TTL_Protocol);
 		return true;
 	} else {
 		return false;
 	}
 }
 
-int8_t IP_GenerateUnicast(uint8_t packet[], IP_Protocol_t protocol, const IP_Address_t *destinationIP, uint8_t payloadLength)
+uint16_t IP_GenerateUnicast(uint8_t packet[], IP_Protocol_t protocol, const IP_Address_t *destinationIP, uint16_t payloadLength)
 {
-	const IP_Address_t *routerIP = destinationIP;
-	if(!(IP_compareNet(&OwnIPAddress, destinationIP)))
-		routerIP = &RouterIPAddress;
+	uint16_t length = IP_WriteHeader(packet + ETHERNET_HEADER_LEN, protocol, destinationIP, payloadLength, DEFAULT_TTL) + payloadLength;
 
-	int8_t offset = Ethernet_GenerateUnicast(packet, routerIP, CPU_TO_BE16(ETHERTYPE_IPV4));
-	if(offset <= 0)
-		return offset;
+	return Ethernet_GenerateUnicast(packet, IP_getNextHop(destinationIP), CPU_TO_BE16(ETHERTYPE_IPV4), length);
+}
 
-	return offset + IP_WriteHeader(packet + offset, protocol, destinationIP, payloadLength);
+uint16_t IP_GenerateBroadcast(uint8_t packet[], IP_Protocol_t protocol, uint16_t payloadLength)
+{
+	uint16_t length = IP_WriteHeader(packet + ETHERNET_HEADER_LEN, protocol, &BroadcastIPAddress, payloadLength, DEFAULT_TTL) + payloadLength;
+
+	return Ethernet_GenerateBroadcast(packet, CPU_TO_BE16(ETHERTYPE_IPV4), length);
 }
 
-uint8_t IP_GenerateBroadcast(uint8_t packet[], IP_Protocol_t protocol, uint8_t payloadLength)
+#ifdef IP_MULTICAST
+uint16_t IP_GenerateMulticast(uint8_t packet[], IP_Protocol_t protocol, uint16_t payloadLength)
 {
-	uint8_t offset = Ethernet_GenerateBroadcast(packet, CPU_TO_BE16(ETHERTYPE_IPV4));
+	uint16_t length = IP_WriteHeader(packet + ETHERNET_HEADER_LEN, protocol, &MulticastIPAddress, payloadLength, MULTICAST_TTL) + payloadLength;
 
-	return offset + IP_WriteHeader(packet + offset, protocol, &BroadcastIPAddress, payloadLength);
+	return Ethernet_GenerateMulticast(packet, &MulticastIPAddress, CPU_TO_BE16(ETHERTYPE_IPV4), length);
 }
+#endif
@@ -2,18 +2,30 @@
 #define _IP_H_
 #include <stdint.h>
 #include "resources.h"
+#include "Ethernet.h"
+
+#define IP_HEADER_LEN		20
+#define IP_PAYLOAD_OFFSET	(ETHERNET_HEADER_LEN + IP_HEADER_LEN)
 
 typedef enum
 {
 	IP_PROTOCOL_ICMP = 1,
+	IP_PROTOCOL_IGMP = 2,
 	IP_PROTOCOL_UDP = 17,
 } IP_Protocol_t;
 
 bool IP_ProcessPacket(uint8_t packet[], uint16_t length) ATTR_WARN_UNUSED_RESULT ATTR_NON_NULL_PTR_ARG(1);
-int8_t IP_GenerateUnicast(uint8_t packet[], IP_Protocol_t protocol, const IP_Address_t *destinationIP, uint8_t payloadLength) ATTR_WARN_UNUSED_RESULT ATTR_NON_NULL_PTR_ARG(1, 3);
-uint8_t IP_GenerateBroadcast(uint8_t packet[], IP_Protocol_t protocol, uint8_t payloadLength) ATTR_WARN_UNUSED_RESULT ATTR_NON_NULL_PTR_ARG(1);
+// The payload has to be in place at packet + IP_PAYLOAD_OFFSET. Returns the length of the frame to send.
+uint16_t IP_GenerateUnicast(uint8_t packet[], IP_Protocol_t protocol, const IP_Address_t *destinationIP, uint16_t payloadLength) ATTR_WARN_UNUSED_RESULT ATTR_NON_NULL_PTR_ARG(1, 3);
+uint16_t IP_GenerateBroadcast(uint8_t packet[], IP_Protocol_t protocol, uint16_t payloadLength) ATTR_WARN_UNUSED_RESULT ATTR_NON_NULL_PTR_ARG(1);
+#ifdef IP_MULTICAST
+// Send to MulticastIPAddress, limited to the local network
+uint16_t IP_GenerateMulticast(uint8_t packet[], IP_Protocol_t protocol, uint16_t payloadLength) ATTR_WARN_UNUSED_RESULT ATTR_NON_NULL_PTR_ARG(1);
+#endif
 
 void IP_ChecksumAdd(uint16_t *checksum, uint16_t word) ATTR_NON_NULL_PTR_ARG(1);
 uint16_t IP_Checksum(const void *data, uint16_t length) ATTR_WARN_UNUSED_RESULT ATTR_NON_NULL_PTR_ARG(1) ATTR_PURE;
+// Adjust checksum after data with one's complement sum oldSum got replaced by data with sum newSum
+void IP_ChecksumUpdate(uint16_t *checksum, uint16_t oldSum, uint16_t newSum) ATTR_NON_NULL_PTR_ARG(1);
 
 #endif
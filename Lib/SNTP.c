@@ -1,11 +1,15 @@
 #include "SNTP.h"
 #include <time.h>
 #include <avr/io.h>
+#include <util/atomic.h>
 #include <string.h>
 #include "UDP.h"
+#include "clock.h"
+#include "USB.h"
 
 #define SNTP_VERSIONMODECLIENT	0x1B
 #define SNTP_VERSIONMODESERVER	0x1C
+#define SNTP_VERSIONMODEBROADCAST	0x1D
 
 typedef struct
 {
@@ -25,67 +29,271 @@ typedef struct
 	uint32_t	TransmitTimestampSec;
 	uint32_t	TransmitTimestampSub;
 } ATTR_PACKED SNTP_Header_t;
+_Static_assert(sizeof(SNTP_Header_t) <= UDP_HOLD_PAYLOAD_MAX, "SNTP request does not fit into ARP_HOLD_LEN");
 
-// Passt den Zahlenraum NTP an den Zahlenraum Timer an
-// 32 Bit werden die Zahlen 0-62498 abgebildet. Mathematisch:
-// Runden(fract * 62498 / 2^32)
-// Eigentlich muesste es auf 0-62499 abgebildet werden, aber dann
-// bin ich mir nicht sicher, dass der Interrupt ausloest
-// Optimiert auf 32Bit Schiebe und Addier-Operationen
-static inline uint16_t frac2timer(uint32_t fract)
+typedef uint64_t SNTP_Time_t;	// NTP format: seconds in the upper, fraction in the lower 32 bit
+
+static SNTP_Time_t SNTP_fromTimestamp(const Timestamp_t *timestamp)
+{
+	return (SNTP_Time_t)(timestamp->seconds + (uint32_t)NTP_OFFSET) << 32 | clock_ticksToNTPFraction(timestamp->ticks);
+}
+
+static inline SNTP_Time_t SNTP_fromPacket(uint32_t sec, uint32_t sub)
 {
-        uint32_t retVal = 0;
-        for (uint8_t i = 15; i; --i)
-        {
-                fract >>= 1;
-                switch(i) {     // Je gesetztem Bit von 62500 addieren
-                case 1:
-                case 5:
-                case 10:
-                case 12:
-                case 13:
-                case 14:
-                case 15: retVal += fract;
-                }
-        }
-
-        return (retVal + 32768) >> 16;
+	return (SNTP_Time_t)be32_to_cpu(sec) << 32 | be32_to_cpu(sub);
+}
+
+// Slew small offsets and let the clock discipline learn the frequency, step large ones
+static time_t SNTP_adjustClock(int64_t offset)
+{
+	const int64_t threshold = ((int64_t)CLOCK_STEP_THRESHOLD_US << 32) / 1000000;
+	if(offset > -threshold && offset < threshold)
+	{
+		clock_discipline((int32_t)(offset * 1000000 >> 32));
+		return time(NULL);
+	}
+
+	Timestamp_t timestamp;
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+	{
+		clock_getTimestamp(&timestamp);
+		SNTP_Time_t time = SNTP_fromTimestamp(&timestamp) + offset;
+
+		timestamp.ticks = clock_NTPFractionToTicks((uint32_t)time);
+		timestamp.seconds = (uint32_t)(time >> 32) - NTP_OFFSET;
+		clock_setTimestamp(&timestamp);
+	}
+	return timestamp.seconds;
+}
+
+// Clock filter: the last samples of each server, only the one with the smallest delay is used
+typedef struct
+{
+	int64_t		offset;		// NTP format
+	uint32_t	delay;		// Microseconds
+} SNTP_Sample_t;
+#define SNTP_NoSample UINT32_MAX
+
+typedef struct
+{
+	SNTP_Time_t	originate;	// Request in flight, 0 if there is none
+	uint8_t		next;
+	SNTP_Sample_t	samples[SNTP_FILTER_SAMPLES];
+} SNTP_Server_t;
+static SNTP_Server_t SNTP_Servers[SNTP_MAX_SERVERS];
+
+// The transmit timestamp of a request carries the server number in its lowest bits
+_Static_assert(SNTP_MAX_SERVERS < 16, "Server number does not fit into the transmit timestamp");
+
+__attribute__((constructor)) static void SNTP_init(void)
+{
+	for(uint8_t server = 0; server < SNTP_MAX_SERVERS; server++)
+		for(uint8_t i = 0; i < SNTP_FILTER_SAMPLES; i++)
+			SNTP_Servers[server].samples[i].delay = SNTP_NoSample;
+}
+
+// Sample with the smallest delay of a server, NULL if there is none
+static const SNTP_Sample_t *SNTP_bestSample(const SNTP_Server_t *server)
+{
+	const SNTP_Sample_t *best = NULL;
+	for(uint8_t i = 0; i < SNTP_FILTER_SAMPLES; i++)
+	{
+		const SNTP_Sample_t *sample = &server->samples[i];
+		if(sample->delay != SNTP_NoSample && (!best || sample->delay < best->delay))
+			best = sample;
+	}
+	return best;
 }
 
 #define MaxRoundTripSec 2
-time_t SNTP_ProcessPacket(uint8_t packet[], uint16_t length)
+bool SNTP_ProcessPacket(uint8_t packet[], uint16_t length, uint8_t server)
 {
-	if(length != sizeof(SNTP_Header_t))
-		return 0;
+	if(length != sizeof(SNTP_Header_t) || server >= SNTP_MAX_SERVERS)
+		return false;
 
 	SNTP_Header_t* SNTP  = (SNTP_Header_t *)packet;
+	SNTP_Server_t *state = &SNTP_Servers[server];
 
-	if ((SNTP->VersionMode & 0x3F) != SNTP_VERSIONMODESERVER || (SNTP->VersionMode & 0xC0) == 0xC0 ||
+	if ((SNTP->VersionMode & 0xC0) == 0xC0 ||
 	    (SNTP->TransmitTimestampSec == 0 && SNTP->TransmitTimestampSub == 0))
+		return false;
+
+	// T4: arrival of the reply, taken in the USB interrupt
+	Timestamp_t timestamp;
+	if(!USB_getRXTimestamp(packet - UDP_PAYLOAD_OFFSET, &timestamp))
+		clock_getTimestamp(&timestamp);
+	SNTP_Time_t received = SNTP_fromTimestamp(&timestamp);
+	SNTP_Time_t transmit = SNTP_fromPacket(SNTP->TransmitTimestampSec, SNTP->TransmitTimestampSub);
+
+	SNTP_Sample_t sample;
+	switch(SNTP->VersionMode & 0x07)
+	{
+		case SNTP_VERSIONMODESERVER & 0x07:
+		{
+			// Only accept the answer to the request in flight
+			if(!state->originate || SNTP_fromPacket(SNTP->OriginateTimestampSec, SNTP->OriginateTimestampSub) != state->originate)
+				return false;
+
+			// T1: the request left through the USB endpoint, T2/T3: server receive and transmit time
+			SNTP_Time_t originate = state->originate;
+			if(USB_getTXTimestamp(SNTP->OriginateTimestampSub, &timestamp))
+				originate = SNTP_fromTimestamp(&timestamp);
+			SNTP_Time_t serverReceived = SNTP_fromPacket(SNTP->ReceiveTimestampSec, SNTP->ReceiveTimestampSub);
+
+			// Round trip without the processing time of the server
+			int64_t delay = (int64_t)(received - originate) - (int64_t)(transmit - serverReceived);
+			if(delay < 0 || delay > ((int64_t)MaxRoundTripSec << 32))
+				return false;
+			state->originate = 0;
+
+			sample.offset = ((int64_t)(serverReceived - originate) + (int64_t)(transmit - received)) / 2;
+			sample.delay = (uint32_t)(delay * 1000000 >> 32);
+		} break;
+#ifdef SNTP_BROADCAST
+		case SNTP_VERSIONMODEBROADCAST & 0x07:
+		{
+			// The broadcast needed half the round trip measured with the last requests to get here
+			const SNTP_Sample_t *best = SNTP_bestSample(state);
+			sample.delay = best ? best->delay : 0;
+			sample.offset = (int64_t)(transmit - received) + (((int64_t)sample.delay << 32) / 1000000) / 2;
+		} break;
+#endif
+		default:
+			return false;
+	}
+
+	state->samples[state->next] = sample;
+	state->next = (state->next + 1) % SNTP_FILTER_SAMPLES;
+	return true;
+}
+
+// Poll exponent, like NTP: the interval doubles after SNTP_PollHysteresis small offsets in a row
+// and halves on each large one
+_Static_assert(SNTP_MinPoll <= SNTP_MaxPoll && SNTP_MaxPoll < 32, "Invalid poll exponents");
+static uint8_t SNTP_Poll = SNTP_MinPoll;
+static uint8_t SNTP_PollStable;
+
+static void SNTP_adaptPoll(int64_t offset)
+{
+	int64_t absOffset = offset < 0 ? -offset : offset;
+	if(absOffset < ((int64_t)SNTP_PollStableUs << 32) / 1000000)
+	{
+		if(++SNTP_PollStable >= SNTP_PollHysteresis)
+		{
+			SNTP_PollStable = 0;
+			if(SNTP_Poll < SNTP_MaxPoll)
+				SNTP_Poll++;
+		}
+	}
+	else
+	{
+		SNTP_PollStable = 0;
+		if(absOffset >= ((int64_t)CLOCK_STEP_THRESHOLD_US << 32) / 1000000)
+			SNTP_Poll = SNTP_MinPoll;	// Clock is stepped, start over
+		else if(absOffset >= ((int64_t)SNTP_PollUnstableUs << 32) / 1000000 && SNTP_Poll > SNTP_MinPoll)
+			SNTP_Poll--;
+	}
+}
+
+uint32_t SNTP_PollInterval(void)
+{
+	return (uint32_t)1 << SNTP_Poll;
+}
+
+bool SNTP_Pending(void)
+{
+	for(uint8_t server = 0; server < SNTP_MAX_SERVERS; server++)
+		if(SNTP_Servers[server].originate)
+			return true;
+	return false;
+}
+
+time_t SNTP_Update(void)
+{
+	// Candidates: the best sample of each server, it is correct within +-delay/2
+	int64_t offset[SNTP_MAX_SERVERS], radius[SNTP_MAX_SERVERS];
+	uint32_t delay[SNTP_MAX_SERVERS];
+	uint8_t candidates = 0;
+	for(uint8_t server = 0; server < SNTP_MAX_SERVERS; server++)
+	{
+		// Late answers of this round are not accepted anymore
+		SNTP_Servers[server].originate = 0;
+
+		const SNTP_Sample_t *best = SNTP_bestSample(&SNTP_Servers[server]);
+		if(!best)
+			continue;
+		offset[candidates] = best->offset;
+		delay[candidates] = best->delay;
+		radius[candidates] = (((int64_t)best->delay << 32) / 1000000) / 2;
+		candidates++;
+	}
+
+	// Falsetickers: find the point covered by the most intervals, a majority has to agree on it
+	uint8_t bestCount = 0;
+	int64_t bestPoint = 0;
+	for(uint8_t i = 0; i < 2 * candidates; i++)
+	{
+		int64_t point = (i & 1) ? offset[i / 2] + radius[i / 2] : offset[i / 2] - radius[i / 2];
+		uint8_t count = 0;
+		for(uint8_t j = 0; j < candidates; j++)
+			if(offset[j] - radius[j] <= point && point <= offset[j] + radius[j])
+				count++;
+		if(count > bestCount)
+		{
+			bestCount = count;
+			bestPoint = point;
+		}
+	}
+	if(!candidates || 2 * bestCount <= candidates)
 		return 0;
 
-	TCNT1 = frac2timer(be32_to_cpu(SNTP->TransmitTimestampSub));
-	time_t newTime = be32_to_cpu(SNTP->TransmitTimestampSec) - NTP_OFFSET;
-	set_system_time(newTime);
+	// Combine the truechimers, weighted by their delay. Relative to the first one, the differences are small
+	int64_t base = 0, sum = 0;
+	uint32_t weights = 0;
+	bool first = true;
+	for(uint8_t i = 0; i < candidates; i++)
+	{
+		if(offset[i] - radius[i] > bestPoint || bestPoint > offset[i] + radius[i])
+			continue;
+		if(first)
+		{
+			base = offset[i];
+			first = false;
+		}
+		// At least 1, round trips up to MaxRoundTripSec count as well
+		uint32_t weight = MAX(1000000 / (delay[i] + 1000), (uint32_t)1);
+		sum += (offset[i] - base) * weight;
+		weights += weight;
+	}
+	int64_t combined = base + sum / weights;
+
+	// All samples were taken against the clock before this correction
+	for(uint8_t server = 0; server < SNTP_MAX_SERVERS; server++)
+		for(uint8_t i = 0; i < SNTP_FILTER_SAMPLES; i++)
+			SNTP_Servers[server].samples[i].offset -= combined;
 
-	return newTime;
+	SNTP_adaptPoll(combined);
+	return SNTP_adjustClock(combined);
 }
 
-int8_t SNTP_GenerateRequest(uint8_t packet[], const IP_Address_t *destinationIP, UDP_Port_t destinationPort)
+uint16_t SNTP_GenerateRequest(uint8_t packet[], uint8_t server, const IP_Address_t *destinationIP, UDP_Port_t destinationPort)
 {
-	int8_t offset = UDP_GenerateUnicast(packet, destinationIP, destinationPort, sizeof(SNTP_Header_t));
-	if(offset < 0)
-		return offset;
+	if(server >= SNTP_MAX_SERVERS)
+		return 0;
 
-	SNTP_Header_t *SNTP = (SNTP_Header_t *)(packet + offset);
+	SNTP_Header_t *SNTP = (SNTP_Header_t *)(packet + UDP_PAYLOAD_OFFSET);
 
 	memset(SNTP, 0, sizeof(SNTP_Header_t));
 	SNTP->VersionMode = SNTP_VERSIONMODECLIENT;
-#ifdef DEBUG
-	SNTP->TransmitTimestampSec = cpu_to_be32(time(NULL) + (uint32_t)NTP_OFFSET);
-	SNTP->TransmitTimestampSub = cpu_to_be32(TCNT1 * (uint32_t)68721);
-#endif
 
-	return offset + sizeof(SNTP_Header_t);
-}
+	// The server copies this into the originate timestamp of the answer. The USB interrupt
+	// finds the time the request was really sent by its fraction, so it has to be unique.
+	Timestamp_t now;
+	clock_getTimestamp(&now);
+	SNTP_Time_t originate = (SNTP_fromTimestamp(&now) & ~(SNTP_Time_t)0xF) | (server + 1);
+	SNTP_Servers[server].originate = originate;
+	SNTP->TransmitTimestampSec = cpu_to_be32((uint32_t)(originate >> 32));
+	SNTP->TransmitTimestampSub = cpu_to_be32((uint32_t)originate);
 
+	return UDP_GenerateUnicast(packet, destinationIP, destinationPort, sizeof(SNTP_Header_t));
+}
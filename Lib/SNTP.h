@@ -4,6 +4,14 @@
 #include <time.h>
 #include "resources.h"
 
-time_t SNTP_ProcessPacket(uint8_t packet[], uint16_t length) ATTR_WARN_UNUSED_RESULT ATTR_NON_NULL_PTR_ARG(1);
-int8_t SNTP_GenerateRequest(uint8_t packet[], const IP_Address_t *destinationIP, UDP_Port_t destinationPort) ATTR_WARN_UNUSED_RESULT ATTR_NON_NULL_PTR_ARG(1, 2);
+// Adds the answer of server (number in the rule's server list) to its clock filter. Returns false if it is not valid.
+bool SNTP_ProcessPacket(uint8_t packet[], uint16_t length, uint8_t server) ATTR_WARN_UNUSED_RESULT ATTR_NON_NULL_PTR_ARG(1);
+// True while requests of this round are not answered yet
+bool SNTP_Pending(void) ATTR_WARN_UNUSED_RESULT;
+// Selects and combines the servers and corrects the clock. Returns the new time or 0 if the servers don't agree.
+time_t SNTP_Update(void) ATTR_WARN_UNUSED_RESULT;
+// Seconds until the next round of requests
+uint32_t SNTP_PollInterval(void) ATTR_WARN_UNUSED_RESULT;
+// Request to server number server of the list, 0 for servers beyond SNTP_MAX_SERVERS
+uint16_t SNTP_GenerateRequest(uint8_t packet[], uint8_t server, const IP_Address_t *destinationIP, UDP_Port_t destinationPort) ATTR_WARN_UNUSED_RESULT ATTR_NON_NULL_PTR_ARG(1, 3);
 #endif
@@ -3,6 +3,7 @@
 #include "helper.h"
 
 #define UDP_PORT_AUTOMAT CPU_TO_BE16(UDP_PORT)
+#define UDP_PORT_NTP CPU_TO_BE16(123)
 
 typedef struct
 {
@@ -13,18 +14,43 @@ typedef struct
 
         uint8_t data[];
 } ATTR_PACKED UDP_Header_t;
+_Static_assert(sizeof(UDP_Header_t) == UDP_HEADER_LEN, "UDP_HEADER_LEN is wrong");
 
-static uint8_t UDP_WriteHeader(uint8_t packet[], UDP_Port_t sourcePort, UDP_Port_t destinationPort, uint8_t payloadLength)
+static uint8_t UDP_WriteHeader(uint8_t packet[], UDP_Port_t sourcePort, UDP_Port_t destinationPort, const IP_Address_t *destinationIP, uint16_t payloadLength)
 {
 	UDP_Header_t *UDP = (UDP_Header_t *)packet;
 
 	UDP->SourcePort = sourcePort;
 	UDP->DestinationPort = destinationPort;
 	UDP->Length = cpu_to_be16(sizeof(UDP_Header_t) + payloadLength);
-	UDP->Checksum = 0;
+
+	// Payload is already in place: add pseudo header and UDP header to the payload sum
+	uint16_t sum = ~IP_Checksum(UDP->data, payloadLength);
+	IP_ChecksumAdd(&sum, sourcePort);
+	IP_ChecksumAdd(&sum, destinationPort);
+	IP_ChecksumAdd(&sum, UDP->Length);
+	IP_ChecksumAdd(&sum, ~IP_Checksum(&OwnIPAddress, sizeof(IP_Address_t)));
+	IP_ChecksumAdd(&sum, ~IP_Checksum(destinationIP, sizeof(IP_Address_t)));
+	IP_ChecksumAdd(&sum, CPU_TO_BE16(IP_PROTOCOL_UDP));
+	IP_ChecksumAdd(&sum, UDP->Length);
+	sum = ~sum;
+	// A calculated checksum of 0 is sent as 0xFFFF, 0 means no checksum
+	UDP->Checksum = sum ? sum : 0xFFFF;
 	return sizeof(UDP_Header_t);
 }
 
+void UDP_ChecksumUpdate(uint8_t packet[], uint16_t oldSum, uint16_t newSum)
+{
+	UDP_Header_t *UDP = (UDP_Header_t *)packet;
+
+	// Checksum 0 means no checksum was sent, don't create one
+	if(!UDP->Checksum)
+		return;
+
+	IP_ChecksumUpdate(&UDP->Checksum, oldSum, newSum);
+	if(!UDP->Checksum)
+		UDP->Checksum = 0xFFFF;
+}
 
 ATTR_WARN_UNUSED_RESULT ATTR_NON_NULL_PTR_ARG(1) ATTR_WEAK
 bool UDP_Callback_Request(uint8_t packet[] ATTR_MAYBE_UNUSED, UDP_Port_t destinationPort ATTR_MAYBE_UNUSED, uint16_t length ATTR_MAYBE_UNUSED)
@@ -49,9 +75,15 @@ bool UDP_ProcessPacket(uint8_t packet[], const IP_Address_t *sourceIP, uint16_t
 
 	if(UDP->SourcePort == UDP_PORT_AUTOMAT)		// This is a request
 	{
+		uint16_t oldSum = UDP->Checksum ? (uint16_t)~IP_Checksum(UDP->data, length) : 0;
 		if(UDP_Callback_Request(UDP->data, be16_to_cpu(UDP->DestinationPort), length))
 		{
-			UDP_WriteHeader(packet, UDP->DestinationPort, UDP->SourcePort, length);
+			// Answer has the same length, swapping ports keeps the checksum, only the payload changed
+			uint16_t port = UDP->SourcePort;
+			UDP->SourcePort = UDP->DestinationPort;
+			UDP->DestinationPort = port;
+			if(UDP->Checksum)
+				UDP_ChecksumUpdate(packet, oldSum, ~IP_Checksum(UDP->data, length));
 			return true;
 		}
 	}
@@ -59,21 +91,37 @@ bool UDP_ProcessPacket(uint8_t packet[], const IP_Address_t *sourceIP, uint16_t
 	{
 		UDP_Callback_Reply(UDP->data, sourceIP, be16_to_cpu(UDP->SourcePort), length);
 	}
+#ifdef SNTP_BROADCAST
+	else if (UDP->DestinationPort == UDP_PORT_NTP && UDP->SourcePort == UDP_PORT_NTP)	// SNTP broadcast
+	{
+		UDP_Callback_Reply(UDP->data, sourceIP, be16_to_cpu(UDP->SourcePort), length);
+	}
+#endif
 	return false;
 }
 
-int8_t UDP_GenerateUnicast(uint8_t packet[], const IP_Address_t *destinationIP, UDP_Port_t destinationPort, uint16_t payloadLength)
+uint16_t UDP_GenerateUnicast(uint8_t packet[], const IP_Address_t *destinationIP, UDP_Port_t destinationPort, uint16_t payloadLength)
+{
+	if(payloadLength > UDP_PAYLOAD_MAX)
+		return 0;
+
+	uint16_t length = UDP_WriteHeader(packet + IP_PAYLOAD_OFFSET, UDP_PORT_AUTOMAT, cpu_to_be16(destinationPort), destinationIP, payloadLength) + payloadLength;
+
+	return IP_GenerateUnicast(packet, IP_PROTOCOL_UDP, destinationIP, length);
+}
+
+uint16_t UDP_GenerateBroadcast(uint8_t packet[], UDP_Port_t sourcePort, uint16_t payloadLength)
 {
-	int8_t offset = IP_GenerateUnicast(packet, IP_PROTOCOL_UDP, destinationIP, sizeof(UDP_Header_t) + payloadLength);
-	if(offset <= 0)
-		return offset;
+	uint16_t length = UDP_WriteHeader(packet + IP_PAYLOAD_OFFSET, cpu_to_be16(sourcePort), UDP_PORT_AUTOMAT, &BroadcastIPAddress, payloadLength) + payloadLength;
 
-	return offset + UDP_WriteHeader(packet + offset, UDP_PORT_AUTOMAT, cpu_to_be16(destinationPort), payloadLength);
+	return IP_GenerateBroadcast(packet, IP_PROTOCOL_UDP, length);
 }
 
-uint8_t UDP_GenerateBroadcast(uint8_t packet[], UDP_Port_t sourcePort, uint16_t payloadLength)
+#ifdef IP_MULTICAST
+uint16_t UDP_GenerateMulticast(uint8_t packet[], UDP_Port_t sourcePort, uint16_t payloadLength)
 {
-	uint8_t offset = IP_GenerateBroadcast(packet, IP_PROTOCOL_UDP, sizeof(UDP_Header_t) + payloadLength);
+	uint16_t length = UDP_WriteHeader(packet + IP_PAYLOAD_OFFSET, cpu_to_be16(sourcePort), UDP_PORT_AUTOMAT, &MulticastIPAddress, payloadLength) + payloadLength;
 
-	return offset + UDP_WriteHeader(packet + offset, cpu_to_be16(sourcePort), UDP_PORT_AUTOMAT, payloadLength);
+	return IP_GenerateMulticast(packet, IP_PROTOCOL_UDP, length);
 }
+#endif
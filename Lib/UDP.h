@@ -2,10 +2,25 @@
 #define _UDP_H_
 #include <stdint.h>
 #include "resources.h"
+#include "IP.h"
+
+#define UDP_HEADER_LEN		8
+#define UDP_PAYLOAD_OFFSET	(IP_PAYLOAD_OFFSET + UDP_HEADER_LEN)
+#define UDP_PAYLOAD_MAX		(PACKET_LEN_MAX - UDP_PAYLOAD_OFFSET)
+// Longest payload that is parked while the destination MAC is resolved, see ARP_HoldFrame
+#define UDP_HOLD_PAYLOAD_MAX	(ARP_HOLD_LEN - UDP_PAYLOAD_OFFSET)
 
 bool UDP_ProcessPacket(uint8_t packet[], const IP_Address_t *sourceIP, uint16_t length) ATTR_WARN_UNUSED_RESULT ATTR_NON_NULL_PTR_ARG(1, 2);
+void UDP_ChecksumUpdate(uint8_t packet[], uint16_t oldSum, uint16_t newSum) ATTR_NON_NULL_PTR_ARG(1);
 
-int8_t UDP_GenerateUnicast(uint8_t packet[], const IP_Address_t *destinationIP, UDP_Port_t destinationPort, uint16_t payloadLength) ATTR_WARN_UNUSED_RESULT ATTR_NON_NULL_PTR_ARG(1, 2);
-uint8_t UDP_GenerateBroadcast(uint8_t packet[], UDP_Port_t sourcePort, uint16_t payloadLength) ATTR_WARN_UNUSED_RESULT ATTR_NON_NULL_PTR_ARG(1);
+// Write the payload to packet + UDP_PAYLOAD_OFFSET first, then generate the headers.
+// Returns the length of the frame to send, this could be an ARP request instead (or 0).
+// Payloads longer than UDP_PAYLOAD_MAX are refused with 0. Payloads longer than UDP_HOLD_PAYLOAD_MAX
+// are only sent to a cached MAC, otherwise the frame is dropped and only the ARP request is sent.
+uint16_t UDP_GenerateUnicast(uint8_t packet[], const IP_Address_t *destinationIP, UDP_Port_t destinationPort, uint16_t payloadLength) ATTR_WARN_UNUSED_RESULT ATTR_NON_NULL_PTR_ARG(1, 2);
+uint16_t UDP_GenerateBroadcast(uint8_t packet[], UDP_Port_t sourcePort, uint16_t payloadLength) ATTR_WARN_UNUSED_RESULT ATTR_NON_NULL_PTR_ARG(1);
+#ifdef IP_MULTICAST
+uint16_t UDP_GenerateMulticast(uint8_t packet[], UDP_Port_t sourcePort, uint16_t payloadLength) ATTR_WARN_UNUSED_RESULT ATTR_NON_NULL_PTR_ARG(1);
+#endif
 #endif
 
@@ -57,6 +57,59 @@ static inline void error(volatile uint8_t *counter)
 static volatile uint8_t errRXShort = 0;
 static volatile uint8_t errRXIPlong = 0;
 static volatile uint8_t errRXIPdontcare = 0;
+static volatile uint8_t errRXChecksum = 0;
+
+// Timestamps of the last SNTP frames, captured as close to the wire as possible.
+// A few entries, so replies of several servers can wait in the PacketBuffer.
+#define USB_TIMESTAMPS	4
+typedef struct
+{
+	uint32_t	key;	// RX: address of the frame, TX: transmit timestamp fraction
+	Timestamp_t	time;
+} USB_Timestamp_t;
+static USB_Timestamp_t RXTimestamps[USB_TIMESTAMPS];
+static USB_Timestamp_t TXTimestamps[USB_TIMESTAMPS];
+
+static void storeTimestamp(USB_Timestamp_t timestamps[], uint8_t *next, uint32_t key, const Timestamp_t *time)
+{
+	// A frame address is reused for later frames, keep only the newest entry per key
+	for(uint8_t i = 0; i < USB_TIMESTAMPS; i++)
+		if(timestamps[i].key == key)
+			timestamps[i].key = 0;
+
+	USB_Timestamp_t *entry = &timestamps[*next];
+	entry->key = key;
+	entry->time = *time;
+	*next = (*next + 1) % USB_TIMESTAMPS;
+}
+
+static bool findTimestamp(const USB_Timestamp_t timestamps[], uint32_t key, Timestamp_t *timestamp)
+{
+	bool found = false;
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+	{
+		for(uint8_t i = 0; i < USB_TIMESTAMPS; i++)
+		{
+			if(timestamps[i].key == key)
+			{
+				*timestamp = timestamps[i].time;
+				found = true;
+				break;
+			}
+		}
+	}
+	return found;
+}
+
+bool USB_getRXTimestamp(const uint8_t frame[], Timestamp_t *timestamp)
+{
+	return findTimestamp(RXTimestamps, (uintptr_t)frame, timestamp);
+}
+
+bool USB_getTXTimestamp(uint32_t transmitTimestampSub, Timestamp_t *timestamp)
+{
+	return findTimestamp(TXTimestamps, transmitTimestampSub, timestamp);
+}
 
 void EVENT_USB_Endpoint_Interrupt(void)
 {
@@ -105,6 +158,21 @@ void EVENT_USB_Endpoint_Interrupt(void)
 
 				if(last)
 				{
+					if(Packet_getLen(packet->state) >= NTP_TRANSMIT_SUB_OFFSET + 4 &&
+					   USB_Check_SNTP(packet->data, NTP_PORT_OFFSET_DESTINATION))
+					{
+						Timestamp_t now;
+						clock_getTimestamp(&now);
+
+						// Transmit timestamp fraction of the request identifies it
+						static uint8_t next;
+						const volatile uint8_t *sub = &packet->data[NTP_TRANSMIT_SUB_OFFSET];
+						uint32_t key;
+						uint8_t *keyBytes = (uint8_t *)&key;
+						REPEAT(4, uint8_t i = 0, keyBytes[i] = sub[i], i++);
+						ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+							storeTimestamp(TXTimestamps, &next, key, &now);
+					}
 					Packet_ReleaseOutput(packet);
 					packet = NULL;
 					enableRX = true;
@@ -121,6 +189,8 @@ void EVENT_USB_Endpoint_Interrupt(void)
 			static volatile uint8_t *writer;
 			static uint8_t receiveBuffer[24];
 			static uint16_t bytesRemaining;
+			static uint32_t checksum;	// Sum of all words starting at the IP header
+			static Timestamp_t received;	// Arrival of the first USB packet of the frame
 			static bool last;
 			static enum {
 				NEEDSPACE = 0,
@@ -138,6 +208,7 @@ void EVENT_USB_Endpoint_Interrupt(void)
 				_Static_assert(CDC_TXRX_EPSIZE >= PACKET_LEN_MIN, "CDC_TXRX_EPSIZE to small");
 				if(usbLen >= PACKET_LEN_MIN)
 				{
+					clock_getTimestamp(&received);
 					bytesRemaining = USB_Read24Byte_Check_GetLength(receiveBuffer);
 					if(bytesRemaining > (uint16_t)usbLen && last)
 					{	// IP Header told us about a larger packet, drop it
@@ -169,6 +240,11 @@ void EVENT_USB_Endpoint_Interrupt(void)
 					uint8_t *reader = receiveBuffer;
 					REPEAT(24, *writer++ = *reader++);
 					bytesRemaining -= 24;
+
+					// First 5 words of the IP header (Ethernet header is 14 byte)
+					const uint16_t *words = (const uint16_t *)&receiveBuffer[14];
+					checksum = 0;
+					REPEAT(5, uint8_t i = 0, checksum += words[i], i++);
 					state = READING;
 				} else { // No space in PacketBuffer
 					enableRX = false;
@@ -179,8 +255,23 @@ void EVENT_USB_Endpoint_Interrupt(void)
 			{
 				uint8_t readLength = (uint8_t)MIN((uint16_t)usbLen, bytesRemaining);
 				bytesRemaining -= readLength;
-				while(readLength--)
-					*writer++ = Endpoint_Read_8();
+				// Sum up words while the bytes are in registers anyway, USB packets have an even length
+				// so only the last byte of a frame can be unpaired
+				_Static_assert(CDC_TXRX_EPSIZE % 2 == 0, "Checksum needs even CDC_TXRX_EPSIZE");
+				for(; readLength >= 2; readLength -= 2)
+				{
+					uint8_t low = Endpoint_Read_8();
+					uint8_t high = Endpoint_Read_8();
+					*writer++ = low;
+					*writer++ = high;
+					checksum += (uint16_t)high << 8 | low;
+				}
+				if(readLength)
+				{
+					uint8_t low = Endpoint_Read_8();
+					*writer++ = low;
+					checksum += low;
+				}
 
 				if(last)
 				{
@@ -190,7 +281,16 @@ void EVENT_USB_Endpoint_Interrupt(void)
 						{
 							error(&errRXShort);
 							Packet_ReleaseInput(packet);
+						} else if(!USB_Check_Checksums(packet->data, checksum)) {
+							error(&errRXChecksum);
+							Packet_ReleaseInput(packet);
 						} else {
+							if(USB_Check_SNTP(packet->data, NTP_PORT_OFFSET_SOURCE))
+							{
+								static uint8_t next;
+								ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+									storeTimestamp(RXTimestamps, &next, (uintptr_t)packet->data, &received);
+							}
 							sleep_disable();
 							Packet_PutInput(packet);
 						}
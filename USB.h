@@ -3,6 +3,15 @@
 #include <stdint.h>
 #include <LUFA/Drivers/USB/USB.h>
 #include "Descriptors.h"
+#include "clock.h"
+#include "net/Police.h"
+
+// Time the first byte of an SNTP reply was received. frame is the start of the Ethernet frame,
+// returns false if the frame was not timestamped.
+bool USB_getRXTimestamp(const uint8_t frame[], Timestamp_t *timestamp) ATTR_WARN_UNUSED_RESULT ATTR_NON_NULL_PTR_ARG(1, 2);
+// Time the last byte of the SNTP request with this transmit timestamp fraction (as sent, big endian)
+// was written to the endpoint, returns false if the request was not sent yet.
+bool USB_getTXTimestamp(uint32_t transmitTimestampSub, Timestamp_t *timestamp) ATTR_WARN_UNUSED_RESULT ATTR_NON_NULL_PTR_ARG(2);
 
 // Should be called, after a packet is put into Output chain.
 static inline void USB_EnableTransmitter(void)
@@ -28,7 +28,7 @@ void processNetworkPackets(void)
 
 int main(void)
 {
-	timer1_init(F_CPU);
+	timer1_init();
 	wdt_enable(WDTO_2S);
 	set_sleep_mode(SLEEP_MODE_IDLE);
 
@@ -49,7 +49,11 @@ int main(void)
 
 //		sendChangedRules();
 
-		sleep_cpu();
-		wdt_reset();
+		// Interrupts with work for the main loop call sleep_disable(). Others, like the one
+		// second tick, only keep the watchdog quiet and the CPU goes back to sleep.
+		do {
+			sleep_cpu();
+			wdt_reset();
+		} while(SMCR & _BV(SE));
 	}
 }
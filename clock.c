@@ -0,0 +1,219 @@
+#include <stdbool.h>
+#include <avr/sleep.h>
+#include "clock.h"
+
+// Maximum slew per second in ticks (500 ppm)
+#define CLOCK_SLEW_MAX		((int16_t)(CLOCK_TICKS_PER_SECOND / 2000))
+// Maximum frequency correction in 1/65536 ticks per second (500 ppm)
+#define CLOCK_FREQUENCY_MAX	((int32_t)(500e-6 * 65536) * (int32_t)CLOCK_TICKS_PER_SECOND)
+// Shorter intervals between two offsets are too noisy to learn the frequency
+#define CLOCK_MIN_INTERVAL	16
+// Only this part of the measured frequency error is corrected at once
+#define CLOCK_FLL_GAIN		2
+
+static volatile uint32_t clock_uptime;		// Seconds since start, not affected by steps
+static volatile int32_t clock_frequency;	// 1/65536 ticks per second, positive: shorter seconds
+static volatile int16_t clock_slew;		// Ticks still to be removed from the coming seconds
+static int32_t clock_phase;			// Fractional ticks of the frequency correction
+static int32_t clock_monotonicShift;		// Keeps the monotonic time continuous when TCNT1 is stepped
+static volatile uint8_t clock_steps;
+static uint32_t clock_lastUpdate;
+static int32_t clock_offset;
+static Time_t clock_alarm;			// Monotonic, see clock_setAlarm
+static bool clock_alarmSet;
+
+static void clock_armAlarm(void);
+
+void clock_tick(void)
+{
+	clock_uptime++;
+
+	// Fractional dithering: a correction of 0.25 ticks removes one tick every 4 seconds
+	int32_t phase = clock_phase + clock_frequency;
+	int16_t whole = (int16_t)(phase >> 16);
+	clock_phase = phase - ((int32_t)whole << 16);
+
+	int16_t slew = clock_slew;
+	if(slew > CLOCK_SLEW_MAX)
+		slew = CLOCK_SLEW_MAX;
+	else if(slew < -CLOCK_SLEW_MAX)
+		slew = -CLOCK_SLEW_MAX;
+	clock_slew -= slew;
+
+	// Counter was just cleared, the new value is used for the running second
+#ifdef TIMER1_USE_ICR
+	ICR1 = CLOCK_COMPARE - whole - slew;
+#else
+	OCR1A = CLOCK_COMPARE - whole - slew;
+#endif
+
+	// Tickless: the main loop is only woken up if the alarm is due in this second
+	clock_armAlarm();
+}
+
+void clock_setTimestamp(const Timestamp_t *timestamp)
+{
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+	{
+		// A pending second must not be counted on the new time, but still on the monotonic time
+		if(TIFR1 & CLOCK_TICK_PENDING)
+		{
+			TIFR1 = CLOCK_TICK_PENDING;
+			clock_tick();
+		}
+
+		clock_slew = 0;
+		// Never set the counter behind the compare value of the running second
+#ifdef TIMER1_USE_ICR
+		uint16_t compare = ICR1;
+#else
+		uint16_t compare = OCR1A;
+#endif
+		uint16_t ticks = MIN(timestamp->ticks, compare);
+		clock_monotonicShift += (int32_t)clock_ticksToFraction(TCNT1) - (int32_t)clock_ticksToFraction(ticks);
+		TCNT1 = ticks;
+		set_system_time(timestamp->seconds);
+		clock_lastUpdate = clock_uptime;
+		clock_steps++;
+	}
+}
+
+// Uptime seconds and the part of the monotonic time below them, which is the timer1 fraction and the shift
+static uint32_t clock_getUptimeFraction(int32_t *fraction)
+{
+	uint32_t seconds;
+	uint16_t ticks;
+	int32_t shift;
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+	{
+		ticks = TCNT1;
+		seconds = clock_uptime;
+		if(TIFR1 & CLOCK_TICK_PENDING)
+		{
+			ticks = TCNT1;
+			seconds++;
+		}
+		shift = clock_monotonicShift;
+	}
+	*fraction = (int32_t)clock_ticksToFraction(ticks) + shift;
+	return seconds;
+}
+
+Time_t clock_getMonotonic(void)
+{
+	int32_t fraction;
+	uint32_t seconds = clock_getUptimeFraction(&fraction);
+	return TIME_SECONDS(seconds) + (Time_t)fraction;
+}
+
+time_t clock_getUptime(void)
+{
+	int32_t fraction;
+	uint32_t seconds = clock_getUptimeFraction(&fraction);
+	return (time_t)(seconds + (fraction >> TIME_FRACTION_BITS));	// Arithmetic shift, rounds down
+}
+
+uint8_t clock_getSteps(void)
+{
+	return clock_steps;
+}
+
+// Wake up now or program compare B, if the alarm is due in the running second. Interrupts have to be disabled.
+static void clock_armAlarm(void)
+{
+	TIMSK1 &= ~_BV(OCIE1B);
+	if(!clock_alarmSet)
+		return;
+
+	Time_t remaining = clock_alarm - clock_getMonotonic();
+	if((int32_t)remaining <= 0)
+	{
+		sleep_disable();
+		return;
+	}
+
+	// Compare B works on the phase of the wall clock second
+	Timestamp_t now;
+	clock_getTimestamp(&now);
+	Time_t fraction = clock_ticksToFraction(now.ticks) + remaining;
+	if(fraction < TIME_SECONDS(1))
+	{
+		// Rounded up, the conversion back must not be before the deadline
+		uint16_t ticks = clock_NTPFractionToTicks(fraction << (32 - TIME_FRACTION_BITS));
+		if(clock_ticksToFraction(ticks) < fraction)
+			ticks++;
+		OCR1B = ticks;
+		TIFR1 = _BV(OCF1B);
+		TIMSK1 |= _BV(OCIE1B);
+		// Counter passed the compare value already
+		if(TCNT1 >= OCR1B)
+			sleep_disable();
+	}
+}
+
+void clock_setAlarm(Time_t deadline)
+{
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+	{
+		clock_alarm = deadline;
+		clock_alarmSet = true;
+		clock_armAlarm();
+	}
+}
+
+void clock_cancelAlarm(void)
+{
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+	{
+		clock_alarmSet = false;
+		clock_armAlarm();
+	}
+}
+
+void clock_discipline(int32_t offsetUs)
+{
+	uint32_t now;
+	int16_t remaining;
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+	{
+		now = clock_uptime;
+		remaining = clock_slew;
+	}
+	uint32_t interval = now - clock_lastUpdate;
+	bool learn = clock_lastUpdate && interval >= CLOCK_MIN_INTERVAL;
+	clock_lastUpdate = now;
+	clock_offset = offsetUs;
+
+	// The part of the last offset which is not slewed yet is still in this one,
+	// only the rest is caused by the frequency error since then
+	int32_t frequency = clock_frequency;
+	if(learn)
+	{
+		int64_t residual = (int64_t)offsetUs - (int64_t)remaining * 1000000 / (int32_t)CLOCK_TICKS_PER_SECOND;
+		int64_t error = residual * (int32_t)CLOCK_TICKS_PER_SECOND * 65536 / 1000000 / (int32_t)interval;
+		frequency += (int32_t)(error / CLOCK_FLL_GAIN);
+		frequency = MAX(MIN(frequency, CLOCK_FREQUENCY_MAX), -CLOCK_FREQUENCY_MAX);
+	}
+	// The new offset replaces the remaining slew. Larger offsets than fit are slewed in parts by the next ones.
+	int64_t ticks = (int64_t)offsetUs * (int32_t)CLOCK_TICKS_PER_SECOND / 1000000;
+	int16_t slew = (int16_t)MAX(MIN(ticks, (int64_t)INT16_MAX), (int64_t)-INT16_MAX);
+
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+	{
+		clock_frequency = frequency;
+		clock_slew = slew;
+	}
+}
+
+int32_t clock_getOffset(void)
+{
+	return clock_offset;
+}
+
+int32_t clock_getDrift(void)
+{
+	int32_t frequency;
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+		frequency = clock_frequency;
+	return (int32_t)((int64_t)frequency * 1000000000 / 65536 / (int32_t)CLOCK_TICKS_PER_SECOND);
+}
@@ -0,0 +1,110 @@
+#ifndef clock_h
+#define clock_h
+
+#include <stdint.h>
+#include <time.h>
+#include <avr/io.h>
+#include <util/atomic.h>
+#include "helper.h"
+
+// Point in time with the resolution of timer1
+typedef struct
+{
+	time_t		seconds;
+	uint16_t	ticks;
+} Timestamp_t;
+
+// Monotonic time in 1/256 s. It wraps after 194 days, so two points in time are only compared
+// by their difference with TIME_BEFORE, which is right as long as they are less than 97 days apart.
+typedef uint32_t Time_t;
+#define TIME_FRACTION_BITS	8
+#define TIME_SECONDS(s)		((Time_t)(s) << TIME_FRACTION_BITS)
+// Rounded up, so a minimum time like RELAY_SPACING_MS is not shortened
+#define TIME_MS(ms)		((Time_t)DIV_ROUND_UP((uint64_t)(ms) << TIME_FRACTION_BITS, 1000))
+#define TIME_BEFORE(a, b)	((int32_t)((Time_t)(a) - (Time_t)(b)) < 0)
+
+// Timer1 configuration, derived from F_CPU at compile time.
+// The smallest prescaler which fits one second into the 16 bit counter gives the best resolution.
+#define CLOCK_PRESCALER		(F_CPU <= 65536ULL ? 1 : F_CPU <= 8 * 65536ULL ? 8 : F_CPU <= 64 * 65536ULL ? 64 : \
+				 F_CPU <= 256 * 65536ULL ? 256 : 1024)
+#define CLOCK_PRESCALER_BITS	(CLOCK_PRESCALER == 1 ? _BV(CS10) : CLOCK_PRESCALER == 8 ? _BV(CS11) : \
+				 CLOCK_PRESCALER == 64 ? (_BV(CS11) | _BV(CS10)) : CLOCK_PRESCALER == 256 ? _BV(CS12) : \
+				 (_BV(CS12) | _BV(CS10)))
+#define CLOCK_TICKS_PER_SECOND	(F_CPU / CLOCK_PRESCALER)
+// Nominal compare value, the discipline trims the real one around it
+#define CLOCK_COMPARE		((uint16_t)(CLOCK_TICKS_PER_SECOND - 1))
+// NTP fraction (2^-32 s) of one tick, rounded up so a converted tick converts back to itself.
+// A power of two number of ticks makes all conversions shifts.
+#define CLOCK_FRACTION_PER_TICK	((uint32_t)(((1ULL << 32) + CLOCK_TICKS_PER_SECOND - 1) / CLOCK_TICKS_PER_SECOND))
+
+_Static_assert(F_CPU <= 1024 * 65536ULL, "F_CPU is too high for timer1");
+_Static_assert(F_CPU % CLOCK_PRESCALER == 0, "F_CPU is no multiple of the timer1 prescaler, a second would not be exact");
+_Static_assert((CLOCK_TICKS_PER_SECOND - 1) * (uint64_t)CLOCK_FRACTION_PER_TICK < (1ULL << 32), "Tick to fraction conversion overflows");
+
+// Timer wrapped, the one second interrupt is still pending
+#ifdef TIMER1_USE_ICR
+#define CLOCK_TICK_PENDING	_BV(ICF1)
+#else
+#define CLOCK_TICK_PENDING	_BV(OCF1A)
+#endif
+
+// Conversions between timer1 ticks and NTP fractions (2^-32 s)
+static inline uint32_t clock_ticksToNTPFraction(uint16_t ticks)
+{
+	return ticks * CLOCK_FRACTION_PER_TICK;
+}
+
+static inline uint16_t clock_NTPFractionToTicks(uint32_t fraction)
+{
+	// fraction * ticks / 2^32 rounded down, in two 16 bit halves to avoid a 64 bit multiplication
+	uint32_t low = ((fraction & 0xFFFF) * (uint32_t)CLOCK_TICKS_PER_SECOND) >> 16;
+	return (uint16_t)(((fraction >> 16) * (uint32_t)CLOCK_TICKS_PER_SECOND + low) >> 16);
+}
+
+static inline Time_t clock_ticksToFraction(uint16_t ticks)
+{
+	return (Time_t)(clock_ticksToNTPFraction(ticks) >> (32 - TIME_FRACTION_BITS));
+}
+
+// Can be called with interrupts enabled and from interrupt context
+static inline void clock_getTimestamp(Timestamp_t *timestamp)
+{
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+	{
+		timestamp->ticks = TCNT1;
+		timestamp->seconds = time(NULL);
+		if(TIFR1 & CLOCK_TICK_PENDING)
+		{
+			timestamp->ticks = TCNT1;
+			timestamp->seconds++;
+		}
+	}
+}
+
+// Time since start, never affected by steps of the wall clock. Use it for all relative timers.
+Time_t clock_getMonotonic(void) ATTR_WARN_UNUSED_RESULT;
+// Whole seconds of the monotonic time, without the wrap
+time_t clock_getUptime(void) ATTR_WARN_UNUSED_RESULT;
+// Incremented each time the wall clock is stepped
+uint8_t clock_getSteps(void) ATTR_WARN_UNUSED_RESULT;
+
+// Offsets larger than this are stepped, smaller ones slewed
+#define CLOCK_STEP_THRESHOLD_US	128000L
+
+// Called by the timer1 interrupt once per second, before system_tick
+void clock_tick(void);
+// Set the clock, forgets a running slew
+void clock_setTimestamp(const Timestamp_t *timestamp) ATTR_NON_NULL_PTR_ARG(1);
+// Wake up the main loop (sleep_disable) at the monotonic deadline. Replaces the previous alarm.
+// The one second tick does not wake the main loop by itself.
+void clock_setAlarm(Time_t deadline);
+void clock_cancelAlarm(void);
+// Feed a measured offset (positive: the clock is behind), it is slewed and trims the frequency
+void clock_discipline(int32_t offsetUs);
+
+// Last measured offset in microseconds
+int32_t clock_getOffset(void) ATTR_WARN_UNUSED_RESULT;
+// Learned frequency correction in ppb (positive: the oscillator is slow)
+int32_t clock_getDrift(void) ATTR_WARN_UNUSED_RESULT;
+
+#endif // clock_h
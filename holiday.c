@@ -0,0 +1,47 @@
+#include <avr/eeprom.h>
+#include "holiday.h"
+#include "clock.h"
+
+_Static_assert(sizeof(HolidayYear_t) == 50, "HolidayYear_t is part of the network protocol");
+
+// Erased EEPROM reads as year 0xFFFF, which never matches
+static HolidayYear_t EEMEM holiday_calendar[HOLIDAY_YEARS];
+// Uptime from which each slot may be written again, limits the wear by a flood of updates
+static time_t holiday_nextWrite[HOLIDAY_YEARS];
+
+static inline HolidayYear_t *holiday_slot(uint16_t year)
+{
+	return &holiday_calendar[year % HOLIDAY_YEARS];
+}
+
+bool holiday_isHoliday(uint16_t year, uint16_t yday)
+{
+	HolidayYear_t *slot = holiday_slot(year);
+	if(eeprom_read_word(&slot->year) != year || yday >= 366)
+		return false;
+	return eeprom_read_byte(&slot->days[yday / 8]) & _BV(yday % 8);
+}
+
+bool holiday_update(uint8_t packet[], uint16_t length)
+{
+	if(length != sizeof(HolidayYear_t))
+		return false;
+
+	const HolidayYear_t *update = (const HolidayYear_t *)packet;
+	HolidayYear_t *slot = holiday_slot(update->year);
+	time_t *nextWrite = &holiday_nextWrite[update->year % HOLIDAY_YEARS];
+	time_t now = clock_getUptime();
+	if(now < *nextWrite)
+		return false;
+
+	// Replayed and reordered requests of the same year are older than the stored one (serial number arithmetic)
+	if(eeprom_read_word(&slot->year) == update->year &&
+	   (int16_t)(update->sequence - eeprom_read_word(&slot->sequence)) <= 0)
+		return false;
+
+	// Only changed bytes are written, the EEPROM cells last longer
+	eeprom_update_block(packet, slot, sizeof(HolidayYear_t));
+	*nextWrite = now + HOLIDAY_WRITE_INTERVAL;
+	eeprom_read_block(packet, slot, sizeof(HolidayYear_t));
+	return true;
+}
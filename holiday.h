@@ -0,0 +1,24 @@
+#ifndef holiday_h
+#define holiday_h
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "helper.h"
+#include "resources.h"
+
+// One bit per day of the year (tm_yday), set for holidays and shutdown days
+typedef struct {
+	uint16_t	year;		// Like 2025
+	uint16_t	sequence;	// Counts the updates of a year, see holiday_update
+	uint8_t		days[DIV_ROUND_UP(366, 8)];
+} ATTR_PACKED HolidayYear_t;
+
+// Holidays count like Sundays for time switches and schedules
+bool holiday_isHoliday(uint16_t year, uint16_t yday) ATTR_WARN_UNUSED_RESULT;
+
+// A request with a HolidayYear_t to HOLIDAY_PORT replaces the calendar of that year, if its sequence
+// number is newer than the stored one (or the year is new) and the year was not written within
+// HOLIDAY_WRITE_INTERVAL. The answer is the stored calendar, rejected requests get none.
+bool holiday_update(uint8_t packet[], uint16_t length) ATTR_NON_NULL_PTR_ARG(1);
+
+#endif
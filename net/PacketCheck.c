@@ -1,10 +1,71 @@
 #include "network.h"
+#include "Police.h"
+#include "clock.h"
 
-uint32_t ip = OwnIPAddress;
+// Ingress policer: one token bucket per class of frames, refilled continuously.
+// Floods of one class are dropped before they reach the PacketBuffer, so other traffic
+// (like the SNTP reply) still finds space.
+static const __flash struct {
+	uint8_t rate;
+	uint8_t burst;
+} PoliceConfig[POLICE_CLASSES] = {
+	[POLICE_ICMP]		= {POLICE_RATE_ICMP, POLICE_BURST_ICMP},
+	[POLICE_ARP]		= {POLICE_RATE_ARP, POLICE_BURST_ARP},
+	[POLICE_ARP_REQUEST]	= {POLICE_RATE_ARP_REQUEST, POLICE_BURST_ARP_REQUEST},
+	[POLICE_UDP_BROADCAST]	= {POLICE_RATE_UDP_BROADCAST, POLICE_BURST_UDP_BROADCAST},
+	[POLICE_UDP_UNICAST]	= {POLICE_RATE_UDP_UNICAST, POLICE_BURST_UDP_UNICAST},
+};
+// Tokens in 1/256, so the refill of a fraction of a second is not lost. The buckets start full.
+#define POLICE_TOKEN		256
+static uint16_t PoliceTokens[POLICE_CLASSES] = {
+	[POLICE_ICMP]		= POLICE_BURST_ICMP * POLICE_TOKEN,
+	[POLICE_ARP]		= POLICE_BURST_ARP * POLICE_TOKEN,
+	[POLICE_ARP_REQUEST]	= POLICE_BURST_ARP_REQUEST * POLICE_TOKEN,
+	[POLICE_UDP_BROADCAST]	= POLICE_BURST_UDP_BROADCAST * POLICE_TOKEN,
+	[POLICE_UDP_UNICAST]	= POLICE_BURST_UDP_UNICAST * POLICE_TOKEN,
+};
+volatile uint8_t PoliceDropped[POLICE_CLASSES];
+
+static inline bool Police(PoliceClass_t class)
+{
+	// Refill lazily in steps of 1/256 s of the monotonic time, which is not affected by SNTP steps
+	static Time_t lastRefill;
+	Time_t now = clock_getMonotonic();
+	Time_t elapsed = now - lastRefill;
+	uint16_t steps;
+	if(elapsed >= TIME_SECONDS(UINT8_MAX))
+	{	// All buckets are full anyway
+		steps = UINT16_MAX;
+		lastRefill = now;
+	} else {
+		steps = (uint16_t)(elapsed >> (TIME_FRACTION_BITS - 8));
+		lastRefill += (Time_t)steps << (TIME_FRACTION_BITS - 8);
+	}
+	if(steps)
+	{
+		for(uint8_t i = 0; i < POLICE_CLASSES; i++)
+		{
+			uint32_t tokens = PoliceTokens[i] + (uint32_t)steps * PoliceConfig[i].rate;
+			PoliceTokens[i] = MIN(tokens, (uint32_t)PoliceConfig[i].burst * POLICE_TOKEN);
+		}
+	}
+
+	if(PoliceTokens[class] >= POLICE_TOKEN)
+	{
+		PoliceTokens[class] -= POLICE_TOKEN;
+		return true;
+	}
+
+	uint8_t dropped = PoliceDropped[class];
+	if(++dropped)
+		PoliceDropped[class] = dropped;
+	return false;
+}
 
 inline uint16_t USB_Read24Byte_Check_GetLength(volatile uint8_t destinationBuffer[])
 {
 	uint8_t data;
+	bool broadcast = false;
 
 	// Destination MAC
 	*destinationBuffer++ = data = UEDATX;
@@ -23,6 +84,7 @@ inline uint16_t USB_Read24Byte_Check_GetLength(volatile uint8_t destinationBuffe
 	}
 	else if(data == GETBYTE_ARRAY(0, MAC_BROADCAST))	// Broadcast
 	{
+		broadcast = true;
 		*destinationBuffer++ = data = UEDATX;
 		if(data != GETBYTE_ARRAY(1, MAC_BROADCAST)) return 0;
 		*destinationBuffer++ = data = UEDATX;
@@ -34,6 +96,27 @@ inline uint16_t USB_Read24Byte_Check_GetLength(volatile uint8_t destinationBuffe
 		*destinationBuffer++ = data = UEDATX;
 		if(data != GETBYTE_ARRAY(5, MAC_BROADCAST)) return 0;
 	}
+#ifdef IP_MULTICAST
+	else if(data == 0x01)					// IPv4 multicast: our group or all hosts (IGMP queries)
+	{
+		broadcast = true;
+		*destinationBuffer++ = data = UEDATX;
+		if(data != 0x00) return 0;
+		*destinationBuffer++ = data = UEDATX;
+		if(data != 0x5E) return 0;
+		// Lower 23 bits of the group address
+		*destinationBuffer++ = data = UEDATX;
+		bool group = data == (GETBYTE_ARRAY(1, IP_MULTICAST) & 0x7F);
+		bool allHosts = data == 0x00;
+		*destinationBuffer++ = data = UEDATX;
+		group = group && data == GETBYTE_ARRAY(2, IP_MULTICAST);
+		allHosts = allHosts && data == 0x00;
+		*destinationBuffer++ = data = UEDATX;
+		group = group && data == GETBYTE_ARRAY(3, IP_MULTICAST);
+		allHosts = allHosts && data == 0x01;
+		if(!group && !allHosts) return 0;
+	}
+#endif
 	else return 0;
 
 	// Source MAC
@@ -74,8 +157,15 @@ inline uint16_t USB_Read24Byte_Check_GetLength(volatile uint8_t destinationBuffe
 
 		// Protocol
 		*destinationBuffer++ = data = UEDATX;
-		if(data != IP_PROTOCOL_ICMP &&		// Support only ICMP and UDP
-		   data != IP_PROTOCOL_UDP) return 0;
+		if(data == IP_PROTOCOL_ICMP) {
+			if(!Police(POLICE_ICMP)) return 0;
+		} else if(data == IP_PROTOCOL_UDP) {
+			if(!Police(broadcast ? POLICE_UDP_BROADCAST : POLICE_UDP_UNICAST)) return 0;
+#ifdef IP_MULTICAST
+		} else if(data == IP_PROTOCOL_IGMP) {
+			if(!Police(POLICE_ICMP)) return 0;
+#endif
+		} else return 0;			// Support only ICMP, IGMP and UDP
 		return iplength;
 	}
 
@@ -101,12 +191,69 @@ inline uint16_t USB_Read24Byte_Check_GetLength(volatile uint8_t destinationBuffe
 		if(data != 4) return 0;	// TODO: sizeof(IP-Address)
 
 		// Operation
-		REPEAT(2, *destinationBuffer++ = UEDATX);
+		uint8_t operationHigh = *destinationBuffer++ = UEDATX;
+		*destinationBuffer++ = data = UEDATX;
+		bool request = !operationHigh && data == GETBYTE(0, ARP_OPERATION_REQUEST);
 
 		// SenderMAC (first 2 bytes)
 		REPEAT(2, *destinationBuffer++ = UEDATX);
 
+		// Broadcast requests are mostly for other hosts. They get their own bucket, so a flood of them
+		// does not block the replies the SNTP client waits for.
+		if(!Police(broadcast && request ? POLICE_ARP_REQUEST : POLICE_ARP)) return 0;
 		return 28 + 14; // sizeof(ARP) + sizeof(Ethernet)
 	}
 	else return 0;
 }
+
+// Fold a 32 bit sum of 16 bit words to a one's complement sum
+static inline uint16_t ChecksumFold(uint32_t sum)
+{
+	sum = (sum & 0xFFFF) + (sum >> 16);
+	return (sum & 0xFFFF) + (sum >> 16);
+}
+
+// Verify IP header and ICMP/UDP checksum of a received frame.
+// sum is the 32 bit sum of all words from the IP header to the end of the frame,
+// accumulated while the frame was copied from the USB endpoint.
+inline bool USB_Check_Checksums(const volatile uint8_t frame[], uint32_t sum)
+{
+	// ARP has no checksum
+	if(frame[12] != GETBYTE(1, ETHERTYPE_IPV4) || frame[13] != GETBYTE(0, ETHERTYPE_IPV4))
+		return true;
+
+	const volatile uint16_t *IP = (const volatile uint16_t *)&frame[14];
+
+	// The header sum of a valid IP header is 0xFFFF (= -0), so sum is also the sum of the IP payload
+	uint32_t headerSum = 0;
+	for(uint8_t i = 0; i < 10; i++)
+		headerSum += IP[i];
+	if(ChecksumFold(headerSum) != 0xFFFF)
+		return false;
+
+	if(frame[14 + 9] == IP_PROTOCOL_UDP)
+	{
+		// UDP Checksum 0: sender did not calculate a checksum
+		if(IP[10 + 3] == 0)
+			return true;
+
+		// Add pseudo header: source and destination address, protocol and UDP length
+		sum += (uint32_t)IP[6] + IP[7] + IP[8] + IP[9];	// 32 bit, int has only 16 bit on the AVR
+		sum += CPU_TO_BE16(IP_PROTOCOL_UDP);
+		sum += IP[10 + 2];
+	}
+
+	return ChecksumFold(sum) == 0xFFFF;
+}
+
+// Check for an IPv4/UDP frame with port 123 (NTP) as source (received replies)
+// or destination (sent requests). Only frames without IP options are handled.
+#define NTP_PORT_OFFSET_SOURCE		(14 + 20 + 0)
+#define NTP_PORT_OFFSET_DESTINATION	(14 + 20 + 2)
+#define NTP_TRANSMIT_SUB_OFFSET		(14 + 20 + 8 + 44)
+inline bool USB_Check_SNTP(const volatile uint8_t frame[], uint8_t portOffset)
+{
+	return frame[12] == GETBYTE(1, ETHERTYPE_IPV4) && frame[13] == GETBYTE(0, ETHERTYPE_IPV4) &&
+	       frame[14 + 9] == IP_PROTOCOL_UDP &&
+	       frame[portOffset] == 0 && frame[portOffset + 1] == 123;
+}
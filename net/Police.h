@@ -0,0 +1,20 @@
+#ifndef _POLICE_H_
+#define _POLICE_H_
+#include <stdint.h>
+
+// Classes of the ingress policer in the receive interrupt
+typedef enum
+{
+	POLICE_ICMP,
+	POLICE_ARP,
+	POLICE_ARP_REQUEST,
+	POLICE_UDP_BROADCAST,
+	POLICE_UDP_UNICAST,
+	POLICE_CLASSES
+} PoliceClass_t;
+
+// Number of frames dropped by the ingress policer per class since the last request to POLICE_PORT,
+// saturates at 255
+extern volatile uint8_t PoliceDropped[POLICE_CLASSES];
+
+#endif
@@ -20,6 +20,7 @@ typedef enum
 typedef enum
 {
 	IP_PROTOCOL_ICMP = 1,
+	IP_PROTOCOL_IGMP = 2,
 	IP_PROTOCOL_UDP = 17,
 } IP_Protocol_t;
 
@@ -30,28 +31,31 @@ typedef enum
 
 bool ARP_ProcessPacket(uint8_t packet[], uint16_t length);
 const MAC_Address_t* ARP_searchMAC(const IP_Address_t *IP);
-uint8_t ARP_GenerateRequest(uint8_t packet[], const IP_Address_t *destinationIP);
+uint16_t ARP_GenerateRequest(uint8_t packet[], const IP_Address_t *destinationIP);
 
 bool Ethernet_ProcessPacket(uint8_t packet[], uint16_t length);
-int8_t Ethernet_GenerateUnicast(uint8_t packet[], const IP_Address_t *destinationIP, Ethertype_t ethertype);
-uint8_t Ethernet_GenerateBroadcast(uint8_t packet[], Ethertype_t ethertype);
+uint16_t Ethernet_GenerateUnicast(uint8_t packet[], const IP_Address_t *destinationIP, Ethertype_t ethertype, uint16_t payloadLength);
+uint16_t Ethernet_GenerateBroadcast(uint8_t packet[], Ethertype_t ethertype, uint16_t payloadLength);
 
 bool ICMP_ProcessPacket(uint8_t packet[]);
 
 bool IP_ProcessPacket(uint8_t packet[], uint16_t length);
-int8_t IP_GenerateUnicast(uint8_t packet[], IP_Protocol_t protocol, const IP_Address_t *destinationIP, uint8_t payloadLength);
-uint8_t IP_GenerateBroadcast(uint8_t packet[], IP_Protocol_t protocol, uint8_t payloadLength);
+uint16_t IP_GenerateUnicast(uint8_t packet[], IP_Protocol_t protocol, const IP_Address_t *destinationIP, uint16_t payloadLength);
+uint16_t IP_GenerateBroadcast(uint8_t packet[], IP_Protocol_t protocol, uint16_t payloadLength);
 
 void IP_ChecksumAdd(uint16_t *checksum, uint16_t word);
 uint16_t IP_Checksum(const void *data, uint16_t length);
 
 #include <time.h>
-time_t SNTP_ProcessPacket(uint8_t packet[], uint16_t length);
-int8_t SNTP_GenerateRequest(uint8_t packet[], const IP_Address_t *destinationIP, UDP_Port_t destinationPort);
+bool SNTP_ProcessPacket(uint8_t packet[], uint16_t length, uint8_t server);
+bool SNTP_Pending(void);
+time_t SNTP_Update(void);
+uint32_t SNTP_PollInterval(void);
+uint16_t SNTP_GenerateRequest(uint8_t packet[], uint8_t server, const IP_Address_t *destinationIP, UDP_Port_t destinationPort);
 
 bool UDP_ProcessPacket(uint8_t packet[], const IP_Address_t *sourceIP, uint16_t length);
 
-int8_t UDP_GenerateUnicast(uint8_t packet[], const IP_Address_t *destinationIP, UDP_Port_t destinationPort, uint16_t payloadLength);
-uint8_t UDP_GenerateBroadcast(uint8_t packet[], UDP_Port_t sourcePort, uint16_t payloadLength);
+uint16_t UDP_GenerateUnicast(uint8_t packet[], const IP_Address_t *destinationIP, UDP_Port_t destinationPort, uint16_t payloadLength);
+uint16_t UDP_GenerateBroadcast(uint8_t packet[], UDP_Port_t sourcePort, uint16_t payloadLength);
 
 #endif
@@ -21,11 +21,15 @@ typedef enum RuleNames {
 	Shutter1RelayOverride,
 } ruleNum_t;
 
+static const __flash IP_Address_t timeServers[] = {
+	CPU_TO_BE32(0xC0A8C803),
+};
+
 static const __flash ruleData_t ruleData[] = {
 // Global rules
 	[SystemError]		= {.type = ptLogic, .data.logic = {.type = LogicForceOff }, .networkPort = 0},		// Should be ptSystemError
-	[TimeOK]		= {.type = ptSNTP, .data.IP = CPU_TO_BE32(0xC0A8C803), .networkPort = 123},
-	[Daylight]		= {.type = ptTimeSwitch, .dependIndex = TimeOK, .data.time = {.wdays = 0b01111111, .starthour = 0, .startmin = 9, .stophour = 0, .stopmin = 10}},	// Should be ptDaylight
+	[TimeOK]		= {.type = ptSNTP, .data.servers = {timeServers, ARRAY_SIZE(timeServers)}, .networkPort = 123},
+	[Daylight]		= {.type = ptDaylight, .dependIndex = TimeOK, .data.daylight = {.latitude = SUN_POSITION(51.0), .longitude = SUN_POSITION(10.0), .twilight = SunCivil}},	// Adjust to the location
 	[SunriseTrigger]	= {.type = ptTrigger, .dependIndex = Daylight, .data.trigger = {.type = TriggerRising, .sec = 3}},
 	[SunsetTrigger]		= {.type = ptTrigger, .dependIndex = Daylight, .data.trigger = {.type = TriggerFalling, .sec = 4}},
 
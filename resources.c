@@ -9,3 +9,7 @@ const IP_Address_t OwnIPAddress = CPU_TO_BE32(GenerateIP(IP_OWN));
 const IP_Address_t BroadcastIPAddress = (CPU_TO_BE32(GenerateIP(IP_OWN)) | ~NETMASK_BE);
 const IP_Address_t RouterIPAddress = CPU_TO_BE32(GenerateIP(IP_ROUTER));
 const IP_Address_t SNTPIPAddress = CPU_TO_BE32(GenerateIP(IP_SNTP));
+#ifdef IP_MULTICAST
+const IP_Address_t MulticastIPAddress = CPU_TO_BE32(GenerateIP(IP_MULTICAST));
+const IP_Address_t AllHostsIPAddress = CPU_TO_BE32(GenerateIP2(224, 0, 0, 1));
+#endif
@@ -12,6 +12,8 @@
 #define MAC_OWN		0x02, 0x00, 0x00, 0x00, 0x00, 0x40
 #define MAC_BROADCAST	0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF
 #define UDP_PORT	65432
+// Optional: send changed rules to this multicast group instead of the broadcast address
+//#define IP_MULTICAST	239, 192, 0, 40
 
 #define PACKET_LEN_MAX	(14+576)
 #define PACKET_LEN_MIN	(14+28) // Ethernet ohne CRC: 14 + ARP/IP+UDP/IP+ICMP: 28
@@ -20,8 +22,53 @@
 
 #define PACKETBUFFER_LEN PACKET_LEN_MAX
 
-//TODO: Change to ONE_DAY
-#define SNTP_TimeBetweenQueries 300
+// Time between SNTP queries is 2^poll seconds. It grows while the measured offsets stay small
+// and shrinks on large corrections. After a restart it starts at the minimum.
+#define SNTP_MinPoll		6	// 64 s
+#define SNTP_MaxPoll		16	// 18.2 h
+#define SNTP_PollStableUs	2000	// Offsets below count as stable
+#define SNTP_PollUnstableUs	8000	// Offsets above shorten the interval at once
+#define SNTP_PollHysteresis	4	// Stable offsets in a row before the interval grows
+// Optional: take the time from SNTP broadcasts (mode 5) of the SNTP rule's server.
+// A unicast query is only sent at startup to measure the delay and if broadcasts stop.
+//#define SNTP_BROADCAST
+#define SNTP_BroadcastTimeout	3600
+// Servers of one SNTP rule and samples kept per server for the clock filter
+#define SNTP_MAX_SERVERS	4
+#define SNTP_FILTER_SAMPLES	4
+
+// Ingress policer: accepted frames per second and burst size for each class
+#define POLICE_RATE_ICMP		2
+#define POLICE_BURST_ICMP		4
+#define POLICE_RATE_ARP			4	// Replies and unicast requests
+#define POLICE_BURST_ARP		8
+#define POLICE_RATE_ARP_REQUEST		4	// Broadcast requests, mostly for other hosts
+#define POLICE_BURST_ARP_REQUEST	8
+#define POLICE_RATE_UDP_BROADCAST	4
+#define POLICE_BURST_UDP_BROADCAST	8
+#define POLICE_RATE_UDP_UNICAST		16
+#define POLICE_BURST_UDP_UNICAST	32
+// A request with POLICE_CLASSES bytes to this port is answered with the dropped frames per class
+#define POLICE_PORT			1001
+
+// Minimum time between two relays switching, relays are switched in rule order
+#define RELAY_SPACING_MS	50
+
+// ptTimeSwitch and ptDaylight rules with today's switching times kept, 5 bytes each.
+// Rules beyond calculate them at each evaluation.
+#define TIME_SWITCH_RULES	8
+
+// Holiday calendar in EEPROM, see holiday.h. A year is replaced by a request to HOLIDAY_PORT.
+#define HOLIDAY_YEARS		4	// 50 bytes each
+#define HOLIDAY_PORT		1000
+#define HOLIDAY_WRITE_INTERVAL	60	// Seconds between two writes of the same year
+
+// Frames waiting for ARP resolution
+#define ARP_HOLD_SLOTS		2
+#define ARP_HOLD_LEN		(14+20+8+48)	// Ethernet + IP + UDP + SNTP
+#define ARP_HOLD_TIMEOUT	2		// Seconds a parked frame waits for the ARP reply
+#define ARP_MAX_TRIES		3		// Unanswered ARP requests before a host counts as unreachable
+#define ARP_NEGATIVE_TIMEOUT	60		// Seconds an unreachable host is not ARPed again
 
 typedef uint32_t IP_Address_t;
 typedef uint16_t UDP_Port_t;
@@ -46,6 +93,15 @@ typedef struct
 
 #define NETMASK (~(uint32_t)(_BV(32 - CIDR) - 1))
 
+extern const MAC_Address_t OwnMACAddress;
+extern const IP_Address_t OwnIPAddress;
+extern const IP_Address_t BroadcastIPAddress;
+extern const IP_Address_t RouterIPAddress;
+#ifdef IP_MULTICAST
+extern const IP_Address_t MulticastIPAddress;
+extern const IP_Address_t AllHostsIPAddress;
+#endif
+
 ATTR_WARN_UNUSED_RESULT ATTR_NON_NULL_PTR_ARG(1, 2) ATTR_PURE ATTR_ALWAYS_INLINE
 static inline bool IP_compareNet(const IP_Address_t *a, const IP_Address_t *b)
 {
@@ -53,6 +109,15 @@ static inline bool IP_compareNet(const IP_Address_t *a, const IP_Address_t *b)
 }
 
 
+// Returns the address which has to be resolved by ARP to reach destinationIP
+ATTR_WARN_UNUSED_RESULT ATTR_NON_NULL_PTR_ARG(1) ATTR_PURE ATTR_ALWAYS_INLINE
+static inline const IP_Address_t *IP_getNextHop(const IP_Address_t *destinationIP)
+{
+	if(IP_compareNet(&OwnIPAddress, destinationIP))
+		return destinationIP;
+	return &RouterIPAddress;
+}
+
 ATTR_WARN_UNUSED_RESULT ATTR_NON_NULL_PTR_ARG(1) ATTR_PURE ATTR_ALWAYS_INLINE
 static inline IP_Hostpart_t IP_getHost(const IP_Address_t *ip)
 {
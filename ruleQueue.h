@@ -0,0 +1,231 @@
+#ifndef ruleQueue_h
+#define ruleQueue_h
+
+// Scheduling of the rule evaluation in checkRules: the rule timers in a min-heap and the rules to
+// check in a worklist, filled from the reverse dependencies of the changed rules.
+// Included by rules.c after ruleData and ruleState, and by the host test in test/.
+//
+// RAM per rule: 2 B for the timer heap, 4 B for the dependents and 2 B for their start index,
+// plus two bitmap bits. 250 rules need about 2 KB on top of ruleState.
+
+// Deadline scheduler: binary min-heap of the rules with a running timer, ordered by ruleState.timer.
+// ruleTimerPos is the position of each rule in the heap, timerNotQueued if its timer is off.
+static ruleNum_t ruleTimerHeap[ARRAY_SIZE(ruleData)];
+static ruleNum_t ruleTimerPos[] = {[0 ... ARRAY_SIZE(ruleData)-1] = (ruleNum_t)ARRAY_SIZE(ruleData)};
+static ruleNum_t ruleTimerCount;
+#define timerNotQueued ((ruleNum_t)ARRAY_SIZE(ruleData))
+
+static inline void timerHeapPlace(ruleNum_t pos, ruleNum_t rule)
+{
+	ruleTimerHeap[pos] = rule;
+	ruleTimerPos[rule] = pos;
+}
+
+// Move the rule at pos up or down until the heap is in order again
+static void timerHeapFix(ruleNum_t pos)
+{
+	ruleNum_t rule = ruleTimerHeap[pos];
+	Time_t timer = ruleState[rule].timer;
+
+	while(pos)
+	{
+		ruleNum_t parent = (pos - 1) / 2;
+		if(!TIME_BEFORE(timer, ruleState[ruleTimerHeap[parent]].timer))
+			break;
+		timerHeapPlace(pos, ruleTimerHeap[parent]);
+		pos = parent;
+	}
+	for(;;)
+	{
+		uint16_t child = 2 * (uint16_t)pos + 1;
+		if(child >= ruleTimerCount)
+			break;
+		if(child + 1 < ruleTimerCount && TIME_BEFORE(ruleState[ruleTimerHeap[child + 1]].timer, ruleState[ruleTimerHeap[child]].timer))
+			child++;
+		if(!TIME_BEFORE(ruleState[ruleTimerHeap[child]].timer, timer))
+			break;
+		timerHeapPlace(pos, ruleTimerHeap[child]);
+		pos = (ruleNum_t)child;
+	}
+	timerHeapPlace(pos, rule);
+}
+
+static inline bool timerRunning(ruleNum_t rule)
+{
+	return ruleTimerPos[rule] != timerNotQueued;
+}
+
+// All changes of a rule timer go through setTimer and clearTimer
+static void setTimer(ruleNum_t rule, Time_t timer)
+{
+	ruleState[rule].timer = timer;
+	ruleNum_t pos = ruleTimerPos[rule];
+
+	if(pos == timerNotQueued)
+	{
+		pos = ruleTimerCount++;
+		timerHeapPlace(pos, rule);
+	}
+	timerHeapFix(pos);
+}
+
+static void clearTimer(ruleNum_t rule)
+{
+	ruleNum_t pos = ruleTimerPos[rule];
+	if(pos == timerNotQueued)
+		return;
+	ruleTimerPos[rule] = timerNotQueued;
+	ruleNum_t last = ruleTimerHeap[--ruleTimerCount];
+	if(last == rule)
+		return;
+	timerHeapPlace(pos, last);
+	timerHeapFix(pos);
+}
+
+__attribute__((constructor)) static void initTimerHeap(void)
+{
+	for(ruleNum_t rule = 0; rule < ARRAY_SIZE(ruleData); rule++)
+		setTimer(rule, ruleState[rule].timer);
+}
+
+// Flag the rules with expired timers, only the expired top of the heap is visited
+static void markExpiredTimers(uint16_t pos, Time_t now, uint8_t expired[])
+{
+	if(pos >= ruleTimerCount)
+		return;
+	ruleNum_t rule = ruleTimerHeap[pos];
+	if(TIME_BEFORE(now, ruleState[rule].timer))
+		return;
+	expired[rule / 8] |= _BV(rule % 8);
+	markExpiredTimers(2 * pos + 1, now, expired);
+	markExpiredTimers(2 * pos + 2, now, expired);
+}
+
+// Reverse dependencies: ruleDependents[ruleDependentsStart[rule] ... ruleDependentsStart[rule + 1] - 1]
+// are the rules using rule as an input, in ascending order.
+static ruleNum_t ruleDependents[4 * ARRAY_SIZE(ruleData)];
+static uint16_t ruleDependentsStart[ARRAY_SIZE(ruleData) + 1];
+
+// Rules in state ruleUnknown or ruleChanged make their dependents check again, see setOK.
+// Initially all rules are unknown.
+#define ruleBitmapSize DIV_ROUND_UP(ARRAY_SIZE(ruleData), 8)
+static uint8_t ruleHot[ruleBitmapSize] = {[0 ... ruleBitmapSize-1] = 0xFF};
+static uint8_t rulePending[ruleBitmapSize];
+
+// Inputs of a rule without duplicates, the same ones checkRules looks at
+static uint8_t ruleInputs(ruleNum_t rule, ruleNum_t inputs[4])
+{
+	ruleNum_t candidates[] = {ruleData[rule].dependIndex, ruleData[rule].data.logic.second, ruleData[rule].data.logic.third, ruleData[rule].data.logic.fourth};
+	uint8_t candidateCount = 1;
+	if(ruleData[rule].type == ptLogic)
+		candidateCount = ARRAY_SIZE(candidates);
+	else if(ruleData[rule].type == ptRelay && ruleData[rule].data.hw.interlock)
+	{
+		candidates[1] = ruleData[rule].data.hw.interlock;
+		candidateCount = 2;
+	}
+
+	uint8_t count = 0;
+	for(uint8_t i = 0; i < candidateCount; i++)
+	{
+		uint8_t known = 0;
+		while(known < count && inputs[known] != candidates[i])
+			known++;
+		if(known == count)
+			inputs[count++] = candidates[i];
+	}
+	return count;
+}
+
+// ruleData is constant, build the lists once at startup (counting sort by input)
+__attribute__((constructor)) static void initDependents(void)
+{
+	ruleNum_t inputs[4];
+	for(ruleNum_t rule = 0; rule < ARRAY_SIZE(ruleData); rule++)
+		for(uint8_t i = ruleInputs(rule, inputs); i--;)
+			ruleDependentsStart[inputs[i] + 1]++;
+	for(ruleNum_t rule = 0; rule < ARRAY_SIZE(ruleData); rule++)
+		ruleDependentsStart[rule + 1] += ruleDependentsStart[rule];
+
+	// ruleDependentsStart[input] is used as write position, afterwards it points to the end of the list
+	for(ruleNum_t rule = 0; rule < ARRAY_SIZE(ruleData); rule++)
+		for(uint8_t i = ruleInputs(rule, inputs); i--;)
+			ruleDependents[ruleDependentsStart[inputs[i]]++] = rule;
+	for(ruleNum_t rule = ARRAY_SIZE(ruleData); rule; rule--)
+		ruleDependentsStart[rule] = ruleDependentsStart[rule - 1];
+	ruleDependentsStart[0] = 0;
+}
+
+// First rule from the given one on with its bit set, ARRAY_SIZE(ruleData) if there is none
+static uint16_t nextRule(const uint8_t bitmap[], uint16_t rule)
+{
+	while(rule < ARRAY_SIZE(ruleData))
+	{
+		uint8_t bits = bitmap[rule / 8] >> (rule % 8);
+		if(!bits)
+		{	// Skip the rest of this byte
+			rule = (rule | 7) + 1;
+			continue;
+		}
+		while(!(bits & 1))
+		{
+			bits >>= 1;
+			rule++;
+		}
+		return rule;
+	}
+	return ARRAY_SIZE(ruleData);
+}
+
+static void markDependents(ruleNum_t rule)
+{
+	for(uint16_t i = ruleDependentsStart[rule]; i < ruleDependentsStart[rule + 1]; i++)
+		rulePending[ruleDependents[i] / 8] |= _BV(ruleDependents[i] % 8);
+}
+
+// All changes of a rule state go through here
+static void setOK(ruleNum_t rule, ruleOK_t ok)
+{
+	ruleState[rule].ok = ok;
+	if(ok == ruleUnknown || ok == ruleChanged)
+	{
+		ruleHot[rule / 8] |= _BV(rule % 8);
+		// Dependents with a higher index are checked in the same run, like in a sweep over all rules
+		markDependents(rule);
+	} else {
+		ruleHot[rule / 8] &= ~_BV(rule % 8);
+	}
+}
+
+static bool checkDependency(ruleNum_t dependIndex, bool *changed)
+{
+	if(ruleState[dependIndex].ok == ruleUnknown) return true;
+	if(ruleState[dependIndex].ok == ruleChanged) *changed = true;
+	return false;
+}
+
+// Check if the inputs are in state unknown (true) or changed their value (*changed)
+static bool checkInputs(ruleNum_t rule, bool *changed)
+{
+	if(checkDependency(ruleData[rule].dependIndex, changed))
+		return true;
+	// For ptLogic type we need to check more dependencies for unknown and changed values.
+	return ruleData[rule].type == ptLogic &&
+		(checkDependency(ruleData[rule].data.logic.second, changed) ||
+		 checkDependency(ruleData[rule].data.logic.third, changed) ||
+		 checkDependency(ruleData[rule].data.logic.fourth, changed));
+}
+
+// Start of a run: flag the rules with an expired timer in expired[] and queue them.
+// Only they and the dependents of unknown or changed rules can do anything. The states stay
+// until the next run, so the dependents of all of them are queued each time.
+static void queuePendingRules(Time_t now, uint8_t expired[])
+{
+	markExpiredTimers(0, now, expired);
+	for(uint8_t i = 0; i < ruleBitmapSize; i++)
+		rulePending[i] |= expired[i];
+	for(uint16_t rule = nextRule(ruleHot, 0); rule < ARRAY_SIZE(ruleData); rule = nextRule(ruleHot, rule + 1))
+		markDependents(rule);
+}
+
+#endif
@@ -1,4 +1,3 @@
-#include <util/delay.h>
 #include <stdint.h>
 #include <stdbool.h>
 #include "rules.h"
@@ -6,7 +5,12 @@
 #include "helper.h"
 #include "timestamp.h"
 #include "USB.h"
+#include "clock.h"
+#include "holiday.h"
+#include "sun.h"
+#include "Lib/ARP.h"
 #include "Lib/Ethernet.h"
+#include "Lib/IGMP.h"
 #include "Lib/SNTP.h"
 #include "Lib/UDP.h"
 
@@ -27,6 +31,8 @@ typedef enum {
 	ptTimeSwitch,
 	ptTrigger,
 	ptDaylight,
+	ptClock,
+	ptSchedule,
 	ptSNTP = -1,	// negative = remote
 	ptRemote = -2
 } ruleType_t;
@@ -69,6 +75,11 @@ typedef enum {
 	MathSet = _BV(7),
 } MathType_t;
 
+typedef enum {
+	ClockOffset,		// Last measured offset in microseconds
+	ClockDrift,		// Frequency correction in ppb
+} ClockValue_t;
+
 typedef enum {
 	TriggerRising = _BV(0),
 	TriggerFalling = _BV(1),
@@ -77,6 +88,16 @@ typedef enum {
 	TriggerBoth = TriggerRising | TriggerFalling,
 } TriggerType_t;
 
+// Window of a ptSchedule rule in minutes since Sunday 00:00 local time.
+// The windows of a rule are sorted by start and must not overlap, the last one may end at the end of the week.
+typedef struct {
+	uint16_t	start;
+	uint16_t	stop;
+} ScheduleWindow_t;
+#define SCHEDULE_MINUTE(wday, hour, min)	((wday) * 1440U + (hour) * 60U + (min))
+#define SCHEDULE_WINDOW(wday, starthour, startmin, stophour, stopmin) \
+	{SCHEDULE_MINUTE(wday, starthour, startmin), SCHEDULE_MINUTE(wday, stophour, stopmin)}
+
 typedef struct {
 	ruleType_t		type;
 	ruleNum_t		dependIndex;
@@ -91,6 +112,11 @@ typedef struct {
 			unsigned stophour  : 6;
 			unsigned stopmin   : 6;
 		} ATTR_PACKED time;
+		struct {
+			signed latitude  : 14;	// See SUN_POSITION
+			signed longitude : 15;
+			unsigned twilight : 2;	// SunTwilight_t
+		} ATTR_PACKED daylight;
 		struct {
 			TriggerType_t type;
 			uint8_t	hour;		// If you provide a time, this acts like a monoflop
@@ -103,72 +129,229 @@ typedef struct {
 			ruleNum_t third;
 			ruleNum_t fourth;
 		} ATTR_PACKED logic;
+		struct {
+			ClockValue_t type;
+		} ATTR_PACKED clock;
+		struct {
+			const __flash IP_Address_t *list;	// All servers are queried at once
+			uint8_t count;
+		} ATTR_PACKED servers;
+		struct {
+			const __flash ScheduleWindow_t *list;	// A whole week
+			uint16_t count;
+		} ATTR_PACKED schedule;
 		struct {
 			HWADDR port;		// Something like &PORTC
 			uint8_t bitValue;	// Something like _BV(PORTC1)
+			ruleNum_t interlock;	// Relay which has to be off before this one switches on, zero means none
 		} ATTR_PACKED hw;
 	} data;
 } ruleData_t;
 _Static_assert(sizeof(((ruleData_t *)0)->data) == 4, "data field grew over 4 bytes");
 
 typedef struct {
-	time_t		timer;
+	Time_t		timer;		// Monotonic, see clock_getMonotonic, only valid while timerRunning
 	ruleValue_t	value;
 	ruleOK_t	ok;
 } ruleState_t;
-#define timerOff UINT32_MAX
+
+#ifdef SNTP_BROADCAST
+// Every broadcast postpones the next query, ask the servers only if broadcasts stop
+#define SNTP_NextQuery SNTP_BroadcastTimeout
+#else
+#define SNTP_NextQuery SNTP_PollInterval()
+#endif
 
 #include STRINGIFY_EXPANDED(CONFIG)
 
-static ruleState_t ruleState[] = {[0 ... ARRAY_SIZE(ruleData)-1] = {.timer = 5}};
+static ruleState_t ruleState[] = {[0 ... ARRAY_SIZE(ruleData)-1] = {.timer = TIME_SECONDS(5)}};
+
+#include "ruleQueue.h"
+
+// Deadline of the calendar (wall clock) as monotonic timer
+static inline Time_t calendarTimer(time_t deadline, Time_t now, const Timestamp_t *wall)
+{
+	return now + TIME_SECONDS(deadline - wall->seconds) - clock_ticksToFraction(wall->ticks);
+}
+
+// Today's switching times of the ptTimeSwitch and ptDaylight rules in minutes after the local midnight
+// timeSwitchDayStart. They are calculated for the first TIME_SWITCH_RULES of them at once at the first
+// evaluation of a new day and kept in rule order, so the other rules take no RAM here. Further calendar
+// rules calculate their times at each evaluation, which happens only a few times a day.
+typedef struct {
+	ruleNum_t	rule;
+	uint16_t	start;
+	uint16_t	stop;
+} timeSwitchDay_t;
+static timeSwitchDay_t timeSwitchDay[TIME_SWITCH_RULES];
+static uint8_t timeSwitchDayCount;
+static time_t timeSwitchDayStart, timeSwitchMidnight;
+static uint16_t timeSwitchDate;		// Local date in days since 2000-01-01
+static uint8_t timeSwitchWday;		// SUNDAY on holidays
+
+static void calculateTimeSwitchDay(ruleNum_t rule, struct tm *tm, timeSwitchDay_t *times)
+{
+	uint16_t dayEnd = (timeSwitchMidnight - timeSwitchDayStart) / 60;
+	times->rule = rule;
+
+	if(ruleData[rule].type == ptDaylight)
+	{
+		time_t rise, set;
+		switch(sun_calculate(timeSwitchDate, ruleData[rule].data.daylight.latitude, ruleData[rule].data.daylight.longitude,
+				     ruleData[rule].data.daylight.twilight, &rise, &set))
+		{
+			case SunNormal:
+			{	// Rounded to minutes, clipped to this day
+				int32_t start = ((int32_t)(rise - timeSwitchDayStart) + 30) / 60;
+				int32_t stop = ((int32_t)(set - timeSwitchDayStart) + 30) / 60;
+				times->start = (uint16_t)MIN(MAX(start, (int32_t)0), (int32_t)dayEnd);
+				times->stop = (uint16_t)MIN(MAX(stop, (int32_t)0), (int32_t)dayEnd);
+			} break;
+
+			case SunAlwaysUp:
+			{
+				times->start = 0;
+				times->stop = dayEnd;
+			} break;
+
+			case SunAlwaysDown:
+			{
+				times->start = times->stop = dayEnd;
+			} break;
+		}
+		return;
+	}
+
+	// Not today: off until midnight
+	if((ruleData[rule].data.time.wdays & _BV(timeSwitchWday)) == 0)
+	{
+		times->start = times->stop = dayEnd;
+		return;
+	}
+	times->start = (calculateTimestamp(tm, ruleData[rule].data.time.starthour, ruleData[rule].data.time.startmin) - timeSwitchDayStart) / 60;
+	times->stop = (calculateTimestamp(tm, ruleData[rule].data.time.stophour, ruleData[rule].data.time.stopmin) - timeSwitchDayStart) / 60;
+}
+
+static void updateTimeSwitchDay(struct tm *tm)
+{
+	timeSwitchMidnight = getMidnight(tm);
+	timeSwitchDayStart = calculateTimestamp(tm, 0, 0);
+	timeSwitchDate = mk_gmtime(tm) / ONE_DAY;	// tm is still at 00:00
+	timeSwitchWday = holiday_isHoliday(tm->tm_year + 1900, tm->tm_yday) ? SUNDAY : tm->tm_wday;
+
+	timeSwitchDayCount = 0;
+	for(ruleNum_t rule = 0; rule < ARRAY_SIZE(ruleData) && timeSwitchDayCount < TIME_SWITCH_RULES; rule++)
+		if(ruleData[rule].type == ptTimeSwitch || ruleData[rule].type == ptDaylight)
+			calculateTimeSwitchDay(rule, tm, &timeSwitchDay[timeSwitchDayCount++]);
+}
+
+// Today's times of a ptTimeSwitch or ptDaylight rule, NULL if it is beyond TIME_SWITCH_RULES
+static const timeSwitchDay_t *findTimeSwitchDay(ruleNum_t rule)
+{
+	uint8_t low = 0, high = timeSwitchDayCount;
+	while(low < high)
+	{
+		uint8_t middle = low + (high - low) / 2;
+		if(timeSwitchDay[middle].rule < rule)
+			low = middle + 1;
+		else
+			high = middle;
+	}
+	return (low < timeSwitchDayCount && timeSwitchDay[low].rule == rule) ? &timeSwitchDay[low] : NULL;
+}
+
+// getStructTM, with the schedule of the day calculated
+static struct tm *getCalendarDay(time_t nowSeconds)
+{
+	struct tm *tm = getStructTM(nowSeconds);
+	if(getMidnight(tm) != timeSwitchMidnight)
+		updateTimeSwitchDay(tm);
+	return tm;
+}
+
+// The wall clock or the holidays changed: calculate the day again and evaluate all calendar rules
+static void invalidateCalendar(void)
+{
+	_nextMidnight = 0;
+	timeSwitchMidnight = 0;
+	for(ruleNum_t rule = 0; rule < ARRAY_SIZE(ruleData); rule++)
+		if(ruleData[rule].type == ptTimeSwitch || ruleData[rule].type == ptDaylight || ruleData[rule].type == ptSchedule)
+			setTimer(rule, clock_getMonotonic());
+}
 
-static bool checkDependency(ruleNum_t dependIndex, bool *changed)
+// Lib/SNTP.c keeps the samples of one server list for the one clock, so only the first ptSNTP rule
+// is served. Further ones would share its samples and its replies on the same port, they stay unknown.
+static ruleNum_t ruleSNTP = ARRAY_SIZE(ruleData);
+// Next server of ruleSNTP to query. Not 0 while the USB queue had no room for the rest of the round.
+static uint8_t sntpNextServer;
+
+__attribute__((constructor)) static void initSNTPRule(void)
 {
-	if(ruleState[dependIndex].ok == ruleUnknown) return true;
-	if(ruleState[dependIndex].ok == ruleChanged) *changed = true;
-	return false;
+	for(ruleNum_t rule = ARRAY_SIZE(ruleData); rule--;)
+		if(ruleData[rule].type == ptSNTP)
+			ruleSNTP = rule;
 }
 
+// Monotonic time the next relay may switch, see RELAY_SPACING_MS
+static Time_t relayNextSwitch;
+
 void checkRules(void)
 {
 //TODO: Hack!
-	ruleState[0].ok = ruleOK;
-	time_t now = time(NULL);
+	setOK(0, ruleOK);
+	Time_t now;
+	Timestamp_t wall;
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+	{
+		now = clock_getMonotonic();
+		clock_getTimestamp(&wall);
+	}
+	time_t nowSeconds = wall.seconds;
 
-	for(ruleNum_t rule = 0; rule < ARRAY_SIZE(ruleData); rule++)
+	// The wall clock was stepped: only the calendar deadlines are wrong, relative timers keep running
+	static uint8_t clockSteps;
+	uint8_t steps = clock_getSteps();
+	if(steps != clockSteps)
 	{
+		clockSteps = steps;
+		invalidateCalendar();
+	}
+
+	uint8_t expired[ruleBitmapSize] = {0};
+	queuePendingRules(now, expired);
+
+	// The worklist is processed in index order, so the result is the same as a sweep over all rules
+	for(uint16_t next = nextRule(rulePending, 0); next < ARRAY_SIZE(ruleData); next = nextRule(rulePending, next + 1))
+	{
+		ruleNum_t rule = (ruleNum_t)next;
+		rulePending[rule / 8] &= ~_BV(rule % 8);
 		bool dependChanged = false;
 
 		// Check if dependency is in state unknown or changed its value
-		if(checkDependency(ruleData[rule].dependIndex, &dependChanged))
- 		{
-			// If the dependency is unknown, we can't proceed
-			ruleState[rule].ok = ruleUnknown;
+		if(checkInputs(rule, &dependChanged))
+		{
+			// If a dependency is unknown, we can't proceed. An expired timer must not stay in the past,
+			// the alarm would wake the main loop at once again and again.
+			setOK(rule, ruleUnknown);
+			if(expired[rule / 8] & _BV(rule % 8))
+				setTimer(rule, now + TIME_SECONDS(1));
 			continue;
 		}
 
-		// For ptLogic type we need to check more dependencies for unknown and changed values.
-		if(ruleData[rule].type == ptLogic)
-		{
-			if(checkDependency(ruleData[rule].data.logic.second, &dependChanged) ||
-			   checkDependency(ruleData[rule].data.logic.third, &dependChanged) ||
-			   checkDependency(ruleData[rule].data.logic.fourth, &dependChanged))
-			{
-				// If a dependency is unknown, we can't proceed
-				ruleState[rule].ok = ruleUnknown;
-				continue;
-	                }
-		}
+		// A relay waiting for its interlock partner is evaluated again when the partner switches
+		if(ruleData[rule].type == ptRelay && ruleData[rule].data.hw.interlock &&
+		   ruleState[ruleData[rule].data.hw.interlock].ok == ruleChanged)
+			dependChanged = true;
 
 		// If we depend on a rule which didn't change in this run and our timer has not expired, skip this rule
-		if(!dependChanged && now < ruleState[rule].timer)
+		if(!dependChanged && !(expired[rule / 8] & _BV(rule % 8)))
 			continue;
 
 		// Start with the dependency rule value as resulting rule value
 		ruleValue_t ruleValue = ruleState[ruleData[rule].dependIndex].value;
 		// Reset State of this rule, but keep Flag ruleSendLater
 		if(ruleState[rule].ok != ruleSendLater)
-			ruleState[rule].ok = ruleOK;
+			setOK(rule, ruleOK);
 
 		switch(ruleData[rule].type)
 		{
@@ -209,120 +392,222 @@ void checkRules(void)
 				if((logictype & LogicINV_Q) == LogicINV_Q)
 					ruleValue = ~ruleValue;
 
-				ruleState[rule].timer = timerOff;
+				clearTimer(rule);
 			} break;
 
 			case ptRelay:
 			{
 //TODO: Irgendwo muss DDR auch gesetzt werden
+				HWADDR port = ruleData[rule].data.hw.port;
+				uint8_t bitValue = ruleData[rule].data.hw.bitValue;
+				ruleNum_t interlock = ruleData[rule].data.hw.interlock;
+				clearTimer(rule);
+
+				if(!ruleValue == !(*port & bitValue))
+					break;
+
+				// Switch on only after the interlock partner is off, its change evaluates this rule again
+				if(ruleValue && interlock && (*ruleData[interlock].data.hw.port & ruleData[interlock].data.hw.bitValue))
+				{
+					ruleValue = ruleState[rule].value;
+					break;
+				}
+
+				// Keep a minimum time between two switching relays without blocking the main loop.
+				// Relays waiting for the same time switch in rule order.
+				// Relays idle for long are free to switch, however far the monotonic time wrapped since
+				Time_t wait = relayNextSwitch - now;
+				if(wait && wait <= TIME_MS(RELAY_SPACING_MS))
+				{
+					ruleValue = ruleState[rule].value;
+					setTimer(rule, relayNextSwitch);
+					break;
+				}
+
 				if(ruleValue)
-					*ruleData[rule].data.hw.port |= ruleData[rule].data.hw.bitValue;
+					*port |= bitValue;
 				else
-					*ruleData[rule].data.hw.port &= ~ruleData[rule].data.hw.bitValue;
-				// Force a delay between each switching relay
-				_delay_ms(50);
-
-				ruleState[rule].timer = timerOff;
+					*port &= ~bitValue;
+				relayNextSwitch = now + TIME_MS(RELAY_SPACING_MS);
 			} break;
 
 			case ptTimeSwitch:
+			case ptDaylight:
 			{
-				struct tm *tm = getStructTM(now);
+				struct tm *tm = getCalendarDay(nowSeconds);
+				timeSwitchDay_t uncached;
+				const timeSwitchDay_t *times = findTimeSwitchDay(rule);
+				if(!times)
+				{
+					calculateTimeSwitchDay(rule, tm, &uncached);
+					times = &uncached;
+				}
 
-				if((ruleData[rule].data.time.wdays & _BV(tm->tm_wday)) == 0)
+				time_t starttime = timeSwitchDayStart + times->start * (time_t)60;
+				time_t stoptime = timeSwitchDayStart + times->stop * (time_t)60;
+				if(nowSeconds < starttime)
 				{
 					ruleValue = 0;
-					ruleState[rule].timer = getMidnight(tm);
-					break;
+					setTimer(rule, calendarTimer(starttime, now, &wall));
+				}
+				else if(nowSeconds < stoptime)
+				{	// Only on or off, nothing to do until the stop time
+					ruleValue = 1;
+					setTimer(rule, calendarTimer(stoptime, now, &wall));
+				} else {
+					ruleValue = 0;
+					setTimer(rule, calendarTimer(timeSwitchMidnight, now, &wall));
 				}
+			} break;
 
-				time_t starttime = calculateTimestamp(tm, ruleData[rule].data.time.starthour, ruleData[rule].data.time.startmin);
-				if(now < starttime)
+			case ptSchedule:
+			{
+				struct tm *tm = getCalendarDay(nowSeconds);
+				const __flash ScheduleWindow_t *list = ruleData[rule].data.schedule.list;
+				uint16_t count = ruleData[rule].data.schedule.count;
+				uint16_t minute = timeSwitchWday * 1440U + ((nowSeconds + tz_offset(nowSeconds)) % ONE_DAY) / 60;
+
+				// Binary search for the number of windows starting before or at this minute
+				uint16_t low = 0, high = count;
+				while(low < high)
 				{
-					ruleValue = 0;
-					ruleState[rule].timer = starttime;
+					uint16_t middle = low + (high - low) / 2;
+					if(list[middle].start <= minute)
+						low = middle + 1;
+					else
+						high = middle;
+				}
+
+				uint16_t next;
+				if(low && minute < list[low - 1].stop)
+				{
+					ruleValue = 1;
+					next = list[low - 1].stop;
 				} else {
-					// Optimization: Remove countdown or calculate only one time (not every second)
-	                                time_t stoptime = calculateTimestamp(tm, ruleData[rule].data.time.stophour, ruleData[rule].data.time.stopmin);
-					if(now < stoptime)
-					{
-						ruleValue = stoptime - now;
-					//TODO: Make Update-Interval configurable
-						ruleState[rule].timer = now + 1;
-					} else {
-						ruleValue = 0;
-						ruleState[rule].timer = getMidnight(tm);
-					}
+					ruleValue = 0;
+					next = (low < count) ? list[low].start : UINT16_MAX;
 				}
+
+				// Changes on later days are found again after midnight
+				time_t deadline = getMidnight(tm);
+				if(next < (timeSwitchWday + 1) * 1440U)
+					deadline = calculateTimestamp(tm, (next % 1440) / 60, next % 60);
+				// The local time does not exist (lost hour in spring), look again a minute later
+				if(deadline <= nowSeconds)
+					deadline = nowSeconds + 60;
+				setTimer(rule, calendarTimer(deadline, now, &wall));
 			} break;
 
 			case ptTrigger:
 			{
 				TriggerType_t triggertype = ruleData[rule].data.trigger.type;
 
-				if(dependChanged && (((triggertype & TriggerMonoflopRetrigger) == TriggerMonoflopRetrigger) || ruleState[rule].timer == timerOff))
+				if(dependChanged && (((triggertype & TriggerMonoflopRetrigger) == TriggerMonoflopRetrigger) || !timerRunning(rule)))
 				{
 					if((((triggertype & TriggerRising) == TriggerRising) && ruleValue) ||
 					   (((triggertype & TriggerFalling) == TriggerFalling) && !ruleValue))
 					{
 						//TODO: Implement countdown?
 						ruleValue = true;
-						ruleState[rule].timer = now + (ruleData[rule].data.trigger.hour * (uint16_t)60 + ruleData[rule].data.trigger.min) * (uint32_t)60 + ruleData[rule].data.trigger.sec;
+						// Counts from the exact time of the change, not from the full second
+						setTimer(rule, now + TIME_SECONDS((ruleData[rule].data.trigger.hour * (uint16_t)60 + ruleData[rule].data.trigger.min) * (uint32_t)60 + ruleData[rule].data.trigger.sec));
 					} else {
 						ruleValue = false;
+						clearTimer(rule);
 					}
 				}
-				else if(ruleState[rule].timer != timerOff)
+				else if(timerRunning(rule))
 				{
-					if(now < ruleState[rule].timer)
+					if(TIME_BEFORE(now, ruleState[rule].timer))
 					{	// Stay on even if dependency switched off
 						ruleValue = true;
 					} else {
 						ruleValue = false;
-						ruleState[rule].timer = timerOff;
+						clearTimer(rule);
 					}
 				}
 			} break;
 
+			case ptClock:
+			{	// Updated whenever the dependency (the SNTP rule) changes
+				if(ruleData[rule].data.clock.type == ClockDrift)
+					ruleValue = (ruleValue_t)clock_getDrift();
+				else
+					ruleValue = (ruleValue_t)clock_getOffset();
+
+				clearTimer(rule);
+			} break;
+
 			case ptSNTP:
+			{
+				if(rule != ruleSNTP)
+				{
+					setOK(rule, ruleUnknown);
+					clearTimer(rule);
+					break;
+				}
+
+				// Timeout: not all servers answered, go on with the others
+				if(!sntpNextServer && SNTP_Pending())
+				{
+					time_t newTime = SNTP_Update();
+					if(newTime)
+					{
+						ruleValue = (ruleValue_t)newTime;
+						setTimer(rule, clock_getMonotonic() + TIME_SECONDS(SNTP_NextQuery));
+						break;
+					}
+				}
+
+				// Query all servers, the answers are collected by UDP_Callback_Reply. The ones
+				// the USB queue has no room for are sent in the next pass of the same round.
+				for(; sntpNextServer < ruleData[rule].data.servers.count; sntpNextServer++)
+				{
+					Packet_t sendPacket;
+					if(!USB_isReady() || !USB_prepareTS(&sendPacket))
+						break;
+
+					const IP_Address_t ipCopy = ruleData[rule].data.servers.list[sntpNextServer];
+					sendPacket.len = SNTP_GenerateRequest(sendPacket.data, sntpNextServer, &ipCopy, ruleData[rule].networkPort);
+					if(sendPacket.len)
+						USB_Send(sendPacket);
+				}
+				if(sntpNextServer < ruleData[rule].data.servers.count)
+					setTimer(rule, now + TIME_SECONDS(1));	// Try again when the queue has room
+				else
+				{
+					sntpNextServer = 0;
+					setTimer(rule, now + TIME_SECONDS(2));	// Timeout 2s in case of no answer
+				}
+				setOK(rule, ruleUnknown);
+			} break;
+
 			case ptRemote:
 			{
 				Packet_t sendPacket;
 				// Check if USB Queue is free
 				if(USB_isReady() && USB_prepareTS(&sendPacket))
 				{
-					int8_t length;
 					const IP_Address_t ipCopy = ruleData[rule].data.IP;
-					if(ruleData[rule].type == ptSNTP)
-					{
-						length = SNTP_GenerateRequest(sendPacket.data, &ipCopy, ruleData[rule].networkPort);
-					} else { // ptRemote: Send Packet with empty body
-						length = UDP_GenerateUnicast(sendPacket.data, &ipCopy, ruleData[rule].networkPort, sizeof(ruleValue_t));
-						if(length > 0)
-						{
-							ruleValue_t *packetValue = (ruleValue_t *)(sendPacket.data + length);
-							*packetValue = 0;
-							length += sizeof(ruleValue_t);
-						}
-					}
-
-					if(length > 0)
-					{
-						sendPacket.len = length;
-						ruleState[rule].timer = now + 2;	// Timeout 2s in case of no answer;
-					} else {
-						sendPacket.len = -length;
-						ruleState[rule].timer =  now + 1;	// Timeout 1s in case of missing ARP entry
-					}
-					USB_Send(sendPacket);
+					// Send Packet with empty body
+					ruleValue_t *packetValue = (ruleValue_t *)(sendPacket.data + UDP_PAYLOAD_OFFSET);
+					*packetValue = 0;
+					sendPacket.len = UDP_GenerateUnicast(sendPacket.data, &ipCopy, ruleData[rule].networkPort, sizeof(ruleValue_t));
+					// In case of missing ARP entry this is an ARP request, the frame is sent after the ARP reply
+					setTimer(rule, now + TIME_SECONDS(2));	// Timeout 2s in case of no answer
+
+					if(sendPacket.len)
+						USB_Send(sendPacket);
 				}
-				ruleState[rule].ok = ruleUnknown;
+				else	// Try again when the queue has room
+					setTimer(rule, now + TIME_SECONDS(1));
+				setOK(rule, ruleUnknown);
 			} break;
 
 			default:
 			{
-				ruleState[rule].ok = ruleUnknown;
-				ruleState[rule].timer = timerOff;
+				setOK(rule, ruleUnknown);
+				clearTimer(rule);
 			} break;
 		}
 
@@ -333,9 +618,26 @@ void checkRules(void)
 		if(ruleState[rule].value != ruleValue)
 		{
 			ruleState[rule].value = ruleValue;
-			ruleState[rule].ok = ruleChanged;
+			setOK(rule, ruleChanged);
 		}
 	}
+
+	// Sleep until the next timer is due, the main loop is not woken up every second
+	bool alarm = ruleTimerCount;
+	Time_t nextTimer = alarm ? ruleState[ruleTimerHeap[0]].timer : 0;
+#ifdef IP_MULTICAST
+	if(IGMP_NextReport() != UINT32_MAX)
+	{
+		Time_t report = TIME_SECONDS(IGMP_NextReport());
+		if(!alarm || TIME_BEFORE(report, nextTimer))
+			nextTimer = report;
+		alarm = true;
+	}
+#endif
+	if(alarm)
+		clock_setAlarm(nextTimer);
+	else
+		clock_cancelAlarm();
 }
 
 // After each rule is processed, send network packets for each changed rule and reset changeflag
@@ -351,18 +653,20 @@ UDP_Port_t port = ruleData[rule].networkPort ? : rule;
 				Packet_t sendPacket;
 				if(USB_isReady() && USB_prepareTS(&sendPacket))
 				{
-					sendPacket.len = UDP_GenerateBroadcast(sendPacket.data, /*ruleData[rule].networkPort*/ port, sizeof(ruleValue_t));
-					ruleValue_t *packetValue = (ruleValue_t *)(sendPacket.data + sendPacket.len);
+					ruleValue_t *packetValue = (ruleValue_t *)(sendPacket.data + UDP_PAYLOAD_OFFSET);
 					*packetValue = ruleState[rule].value;
-
-					sendPacket.len += sizeof(ruleValue_t);
+#ifdef IP_MULTICAST
+					sendPacket.len = UDP_GenerateMulticast(sendPacket.data, port, sizeof(ruleValue_t));
+#else
+					sendPacket.len = UDP_GenerateBroadcast(sendPacket.data, /*ruleData[rule].networkPort*/ port, sizeof(ruleValue_t));
+#endif
 					USB_Send(sendPacket);
 
-					ruleState[rule].ok = ruleOK;
+					setOK(rule, ruleOK);
 				}
 				// else: could not send packet, try again next round
 			} else {
-				ruleState[rule].ok = ruleSendLater;
+				setOK(rule, ruleSendLater);
 			}
 		}
 	}
@@ -380,6 +684,86 @@ void processNetworkPackets(void)
 		else
 			USB_EnableReceiver();
 	}
+
+	// Send frames which were waiting for the ARP reply just processed
+	Packet_t sendPacket;
+	if(USB_isReady() && USB_prepareTS(&sendPacket))
+	{
+		sendPacket.len = ARP_GetHeldFrame(sendPacket.data);
+#ifdef IP_MULTICAST
+		// Join the group / answer membership queries
+		if(!sendPacket.len)
+			sendPacket.len = IGMP_GenerateReport(sendPacket.data);
+#endif
+		if(sendPacket.len)
+			USB_Send(sendPacket);
+	}
+}
+
+// Dispatch index for received UDP packets: all rules sorted by
+// local before remote, then networkPort, then IP (remote rules only).
+// Rules with identical keys keep their order, so the first rule in ruleData wins like before.
+_Static_assert(ARRAY_SIZE(ruleData) < UINT8_MAX, "ruleNum_t too small for dispatch index");
+static ruleNum_t ruleDispatchIndex[ARRAY_SIZE(ruleData)];
+#define ruleNotFound ((ruleNum_t)ARRAY_SIZE(ruleData))
+
+// SNTP rules have a list of servers, they are found by port only
+static IP_Address_t dispatchIP(ruleNum_t rule)
+{
+	return (ruleData[rule].type == ptRemote) ? ruleData[rule].data.IP : 0;
+}
+
+static int8_t compareDispatchKey(ruleNum_t rule, bool remote, UDP_Port_t port, IP_Address_t IP)
+{
+	bool ruleRemote = (ruleData[rule].type < 0);
+	if(ruleRemote != remote)
+		return ruleRemote ? 1 : -1;
+
+	UDP_Port_t rulePort = ruleData[rule].networkPort;
+	if(rulePort != port)
+		return (rulePort < port) ? -1 : 1;
+
+	if(!remote)
+		return 0;
+
+	IP_Address_t ruleIP = dispatchIP(rule);
+	if(ruleIP != IP)
+		return (ruleIP < IP) ? -1 : 1;
+	return 0;
+}
+
+// ruleData is constant, sort it once at startup (insertion sort is stable)
+__attribute__((constructor)) static void initDispatchIndex(void)
+{
+	for(ruleNum_t rule = 0; rule < ARRAY_SIZE(ruleData); rule++)
+	{
+		bool remote = (ruleData[rule].type < 0);
+		UDP_Port_t port = ruleData[rule].networkPort;
+		IP_Address_t IP = dispatchIP(rule);
+
+		ruleNum_t pos = rule;
+		for(; pos && compareDispatchKey(ruleDispatchIndex[pos - 1], remote, port, IP) > 0; pos--)
+			ruleDispatchIndex[pos] = ruleDispatchIndex[pos - 1];
+		ruleDispatchIndex[pos] = rule;
+	}
+}
+
+// Binary search for the first rule matching the key, returns ruleNotFound if there is none
+static ruleNum_t findDispatchRule(bool remote, UDP_Port_t port, IP_Address_t IP)
+{
+	ruleNum_t low = 0, high = ARRAY_SIZE(ruleData);
+	while(low < high)
+	{
+		ruleNum_t middle = low + (high - low) / 2;
+		if(compareDispatchKey(ruleDispatchIndex[middle], remote, port, IP) < 0)
+			low = middle + 1;
+		else
+			high = middle;
+	}
+
+	if(low < ARRAY_SIZE(ruleData) && compareDispatchKey(ruleDispatchIndex[low], remote, port, IP) == 0)
+		return ruleDispatchIndex[low];
+	return ruleNotFound;
 }
 
 ATTR_WARN_UNUSED_RESULT ATTR_NON_NULL_PTR_ARG(1)
@@ -387,59 +771,85 @@ bool UDP_Callback_Request(uint8_t packet[], UDP_Port_t destinationPort, uint16_t
 {
 	ruleValue_t *packetValue = (ruleValue_t *)packet;
 
+	if(destinationPort == HOLIDAY_PORT)
+	{
+		if(!holiday_update(packet, length))
+			return false;
+		invalidateCalendar();
+		return true;
+	}
+
+	if(destinationPort == POLICE_PORT)
+	{
+		if(length != POLICE_CLASSES)
+			return false;
+		// Counted from zero again, so a saturated counter shows up only until it is read
+		for(uint8_t i = 0; i < POLICE_CLASSES; i++)
+			ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+			{
+				packet[i] = PoliceDropped[i];
+				PoliceDropped[i] = 0;
+			}
+		return true;
+	}
+
 	if(length != sizeof(ruleValue_t) || *packetValue != 0)
 		return false;
 
-	for(ruleNum_t rule = 0; rule < ARRAY_SIZE(ruleData); rule++)
-	{
-		if(ruleData[rule].type < 0) continue;
-		if(ruleData[rule].networkPort != destinationPort) continue;
-		// Now we know the packet is for the current rule
+	ruleNum_t rule = findDispatchRule(false, destinationPort, 0);
+	if(rule == ruleNotFound)
+		return false;
 
-		// Don't send an answer, if value is unknown
-		if(ruleState[rule].ok == ruleUnknown) break;
+	// Don't send an answer, if value is unknown
+	if(ruleState[rule].ok == ruleUnknown)
+		return false;
 
-		*packetValue = ruleState[rule].value;
-		ruleState[rule].ok = ruleOK; // If the rule was in state ruleChanged or ruleSendLater, this is now fixed
-		return true;
-	}
-	return false;
+	*packetValue = ruleState[rule].value;
+	setOK(rule, ruleOK); // If the rule was in state ruleChanged or ruleSendLater, this is now fixed
+	return true;
 }
 
 ATTR_NON_NULL_PTR_ARG(1, 2)
 void UDP_Callback_Reply(uint8_t packet[], const IP_Address_t *sourceIP, UDP_Port_t sourcePort, uint16_t length)
 {
-	for(ruleNum_t rule = 0; rule < ARRAY_SIZE(ruleData); rule++)
+	ruleNum_t rule = findDispatchRule(true, sourcePort, *sourceIP);
+	if(rule == ruleNotFound)
+		rule = findDispatchRule(true, sourcePort, 0);
+	if(rule == ruleNotFound)
+		return;
+
+	ruleValue_t ruleValue;
+	if(ruleData[rule].type == ptSNTP)
 	{
-		if(ruleData[rule].type >= 0) continue;
-		if(ruleData[rule].networkPort != sourcePort) continue;
-		if(ruleData[rule].data.IP != *sourceIP) continue;
-
-		// Now we know the packet is for the current rule
-		ruleValue_t ruleValue;
-		if(ruleData[rule].type == ptSNTP)
-		{
-			time_t newTime = SNTP_ProcessPacket(packet, length);
-			if(!newTime) break;
-
-			ruleValue = (ruleValue_t)newTime;
-			ruleState[rule].timer = newTime + SNTP_TimeBetweenQueries;
-		} else { // ptRemote
-			if(length != sizeof(ruleValue_t))
-				break;
-
-			ruleValue = *(ruleValue_t *)packet;
-			ruleState[rule].timer = timerOff;
-		}
-		if(ruleState[rule].value == ruleValue)
-		{
-			ruleState[rule].ok = ruleOK;
-		} else {
-			ruleState[rule].value = ruleValue;
-			ruleState[rule].ok = ruleChanged;
-		}
-
-		// Don't check this packet against later rules
-		break;
+		if(rule != ruleSNTP)
+			return;
+		uint8_t server = 0;
+		while(server < ruleData[rule].data.servers.count && ruleData[rule].data.servers.list[server] != *sourceIP)
+			server++;
+		if(server == ruleData[rule].data.servers.count || !SNTP_ProcessPacket(packet, length, server))
+			return;
+
+		// Wait for the other servers of this round, also the ones not sent yet.
+		// SNTP_Update runs at the timeout otherwise.
+		if(SNTP_Pending() || sntpNextServer)
+			return;
+		time_t newTime = SNTP_Update();
+		if(!newTime) return;
+
+		ruleValue = (ruleValue_t)newTime;
+		setTimer(rule, clock_getMonotonic() + TIME_SECONDS(SNTP_NextQuery));
+	} else { // ptRemote
+		if(length != sizeof(ruleValue_t))
+			return;
+
+		ruleValue = *(ruleValue_t *)packet;
+		clearTimer(rule);
+	}
+	if(ruleState[rule].value == ruleValue)
+	{
+		setOK(rule, ruleOK);
+	} else {
+		ruleState[rule].value = ruleValue;
+		setOK(rule, ruleChanged);
 	}
 }
@@ -0,0 +1,103 @@
+#include "sun.h"
+
+// Sunrise equation (NOAA, simplified) in fixed point.
+// Angles are binary (65536 = 360°), so a full turn of the hour angle is exactly one day in 1/65536 days.
+// Times are in 1/65536 days relative to J2000.0 (2000-01-01 12:00 UTC).
+
+#define SUN_ANGLE32(degrees)	((uint32_t)((degrees) / 360.0 * 4294967296.0))
+#define SUN_Q15(value)		((int32_t)((value) * 32768.0 + ((value) < 0 ? -0.5 : 0.5)))
+#define SUN_DAYS(days)		((int32_t)((days) * 65536.0 + 0.5))
+
+// Mean anomaly at J2000.0 and its change per day
+#define SUN_ANOMALY		SUN_ANGLE32(357.5291)
+#define SUN_ANOMALY_PER_DAY	((int64_t)SUN_ANGLE32(0.98560028))
+// Equation of the centre
+#define SUN_CENTER1		((int64_t)SUN_ANGLE32(1.9148))
+#define SUN_CENTER2		((int64_t)SUN_ANGLE32(0.0200))
+// Argument of the perihelion plus 180°
+#define SUN_PERIHELION		SUN_ANGLE32(180 + 102.9372)
+#define SUN_SIN_OBLIQUITY	SUN_Q15(0.397777)	// sin(23.4397°)
+
+// sin of the elevation for each SunTwilight_t
+static const __flash int16_t sun_sinElevation[] = {
+	[SunRiseSet]		= SUN_Q15(-0.014544),
+	[SunCivil]		= SUN_Q15(-0.104528),
+	[SunNautical]		= SUN_Q15(-0.207912),
+	[SunAstronomical]	= SUN_Q15(-0.309017),
+};
+
+// Sine in Q15 (7th order polynomial on the first quarter, error below 1e-4)
+static int16_t sun_sin(uint16_t angle)
+{
+	uint16_t quarter = angle & 0x3FFF;
+	if(angle & 0x4000)
+		quarter = 0x4000 - quarter;
+
+	int32_t z = (int32_t)quarter << 1;	// 0 ... 1 in Q15
+	int32_t z2 = (z * z) >> 15;
+	int32_t s = SUN_Q15(0.0794648) - ((z2 * SUN_Q15(0.0043527)) >> 15);
+	s = SUN_Q15(0.6459060) - ((z2 * s) >> 15);
+	s = (z * (SUN_Q15(1.5707924) - ((z2 * s) >> 15))) >> 15;
+	s = MIN(s, (int32_t)INT16_MAX);
+
+	return (angle & 0x8000) ? -(int16_t)s : (int16_t)s;
+}
+
+static inline int16_t sun_cos(uint16_t angle)
+{
+	return sun_sin(angle + 0x4000);
+}
+
+// Inverse of sun_cos (0 ... 180°), bisection is exact to one unit and cheap enough for once a day
+static uint16_t sun_acos(int16_t value)
+{
+	uint16_t low = 0, high = 0x8000;
+	while(high - low > 1)
+	{
+		uint16_t middle = low + (high - low) / 2;
+		if(sun_cos(middle) > value)
+			low = middle;
+		else
+			high = middle;
+	}
+	return low;
+}
+
+// 1/65536 days since J2000.0 to UTC timestamp
+static inline time_t sun_toTimestamp(int32_t time)
+{
+	return (time_t)(((int64_t)time * ONE_DAY >> 16) + ONE_DAY / 2);
+}
+
+SunDay_t sun_calculate(uint16_t day, int16_t latitude, int16_t longitude, SunTwilight_t twilight, time_t *rise, time_t *set)
+{
+	// Mean solar noon
+	int32_t noon = ((int32_t)day << 16) + SUN_DAYS(0.0008) - (int32_t)longitude * 65536 / (64 * 360);
+
+	uint32_t anomaly = SUN_ANOMALY + (uint32_t)((int64_t)noon * SUN_ANOMALY_PER_DAY >> 16);
+	int16_t sinAnomaly = sun_sin(anomaly >> 16);
+	int16_t sin2Anomaly = sun_sin((anomaly >> 16) * 2);
+	uint32_t center = (uint32_t)((sinAnomaly * SUN_CENTER1 + sin2Anomaly * SUN_CENTER2) >> 15);
+	uint16_t eclipticLongitude = (anomaly + center + SUN_PERIHELION) >> 16;
+
+	// Solar transit (equation of time)
+	int32_t transit = noon + ((sinAnomaly * SUN_DAYS(0.0053)) >> 15) - ((sun_sin(eclipticLongitude * 2) * SUN_DAYS(0.0069)) >> 15);
+
+	// Declination
+	int16_t sinDeclination = (sun_sin(eclipticLongitude) * SUN_SIN_OBLIQUITY) >> 15;
+	int16_t cosDeclination = sun_sin(sun_acos(sinDeclination));
+
+	// Hour angle of the elevation: cos = (sin(elevation) - sin(lat) sin(decl)) / (cos(lat) cos(decl)), all Q30
+	uint16_t phi = (uint16_t)((int32_t)latitude * 65536 / (64 * 360));
+	int32_t numerator = ((int32_t)sun_sinElevation[twilight] << 15) - (int32_t)sun_sin(phi) * sinDeclination;
+	int32_t denominator = (int32_t)sun_cos(phi) * cosDeclination;
+	if(numerator >= denominator)
+		return SunAlwaysDown;
+	if(numerator <= -denominator)
+		return SunAlwaysUp;
+
+	uint16_t hourAngle = sun_acos((int16_t)(((int64_t)numerator << 15) / denominator));
+	*rise = sun_toTimestamp(transit - hourAngle);
+	*set = sun_toTimestamp(transit + hourAngle);
+	return SunNormal;
+}
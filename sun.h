@@ -0,0 +1,30 @@
+#ifndef sun_h
+#define sun_h
+
+#include <stdint.h>
+#include <time.h>
+#include "helper.h"
+
+// Latitude (north positive) and longitude (east positive) in 1/64 degree
+#define SUN_POSITION(degrees)	((int16_t)((degrees) * 64))
+
+// Elevation of the sun centre which counts as sunrise and sunset
+typedef enum {
+	SunRiseSet,		// -0.833°, upper limb at the horizon with refraction
+	SunCivil,		// -6°
+	SunNautical,		// -12°
+	SunAstronomical,	// -18°
+} SunTwilight_t;
+
+typedef enum {
+	SunNormal,		// Rise and set are valid
+	SunAlwaysUp,		// Polar day
+	SunAlwaysDown,		// Polar night
+} SunDay_t;
+
+// Sunrise and sunset of the day (days since 2000-01-01) as UTC timestamps.
+// Fixed point only, the accuracy is about one minute outside the polar regions.
+SunDay_t sun_calculate(uint16_t day, int16_t latitude, int16_t longitude, SunTwilight_t twilight, time_t *rise, time_t *set)
+		ATTR_WARN_UNUSED_RESULT ATTR_NON_NULL_PTR_ARG(5, 6);
+
+#endif
@@ -0,0 +1,132 @@
+// Frames parked while their next hop is resolved by ARP: one slot per frame, expiry and negative cache
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "../Lib/ARP.c"
+
+// ARP runs on the monotonic seconds
+static time_t uptime;
+time_t clock_getUptime(void)
+{
+	return uptime;
+}
+
+static unsigned failures;
+static void check(bool ok, const char *test, unsigned run)
+{
+	if(!ok && failures++ < 10)
+		printf("FAIL %s, %u\n", test, run);
+}
+
+static const IP_Address_t router = CPU_TO_BE32(0xC0A8C803);
+static const IP_Address_t neighbour = CPU_TO_BE32(0xC0A8C80A);
+static const MAC_Address_t routerMAC = {{0x02, 0x00, 0x00, 0x00, 0x00, 0x03}};
+
+// Park a frame with marker as its first payload byte, returns the length of the ARP request
+static uint16_t holdFrame(const IP_Address_t *nextHop, uint8_t marker, uint16_t length)
+{
+	static uint8_t packet[PACKET_LEN_MAX];
+	memset(packet, 0, ETHERNET_HEADER_LEN);
+	packet[ETHERNET_HEADER_LEN] = marker;
+	return ARP_HoldFrame(packet, length, nextHop);
+}
+
+static void replyFrom(const IP_Address_t *IP, const MAC_Address_t *MAC)
+{
+	ARP_Header_t reply = {
+		.HardwareType = CPU_TO_BE16(ARP_HARDWARE_ETHERNET),
+		.ProtocolType = CPU_TO_BE16(ETHERTYPE_IPV4),
+		.HLEN = sizeof(MAC_Address_t),
+		.PLEN = sizeof(IP_Address_t),
+		.Operation = CPU_TO_BE16(ARP_OPERATION_REPLY),
+		.SenderMAC = *MAC,
+		.SenderIP = *IP,
+		.TargetMAC = OwnMACAddress,
+		.TargetIP = OwnIPAddress,
+	};
+	check(!ARP_ProcessPacket((uint8_t *)&reply, sizeof(reply)), "no answer to a reply", 0);
+}
+
+// Markers of the frames released by the ARP replies, in order
+static unsigned heldFrames(uint8_t markers[])
+{
+	static uint8_t packet[PACKET_LEN_MAX];
+	unsigned count = 0;
+	while(ARP_GetHeldFrame(packet))
+	{
+		check(!memcmp(packet, &routerMAC, sizeof(routerMAC)), "destination MAC filled in", count);
+		markers[count++] = packet[ETHERNET_HEADER_LEN];
+	}
+	return count;
+}
+
+static void testFramePerSlot(void)
+{
+	// Requests to two SNTP servers behind the router don't replace each other
+	check(holdFrame(&router, 1, 90) != 0, "first frame", 0);
+	check(holdFrame(&router, 2, 90) != 0, "second frame", 0);
+	replyFrom(&router, &routerMAC);
+	uint8_t markers[ARP_HOLD_SLOTS + 1];
+	check(heldFrames(markers) == 2 && markers[0] == 1 && markers[1] == 2, "both frames sent", 0);
+	check(heldFrames(markers) == 0, "each frame sent once", 0);
+}
+
+static void testExpiry(void)
+{
+	uptime += 1000;
+	for(uint8_t i = 0; i < ARP_HOLD_SLOTS; i++)
+		check(holdFrame(&neighbour, i, 60) != 0, "fill the slots", i);
+
+	// Nobody answers, after ARP_HOLD_TIMEOUT the slots are free for another host
+	uptime += ARP_HOLD_TIMEOUT;
+	check(holdFrame(&router, 10, 60) != 0, "frame after the timeout", 0);
+	replyFrom(&neighbour, &routerMAC);
+	replyFrom(&router, &routerMAC);
+	uint8_t markers[ARP_HOLD_SLOTS + 1];
+	check(heldFrames(markers) == 1 && markers[0] == 10, "only the new frame sent", 0);
+}
+
+static void testUnreachable(void)
+{
+	uptime += 1000;
+	const IP_Address_t silent = CPU_TO_BE32(0xC0A8C814);
+
+	// Several frames in one second are one try
+	for(uint8_t i = 0; i < 5; i++)
+		check(holdFrame(&silent, i, 60) != 0, "frames in the same second", i);
+	for(uint8_t try = 2; try <= ARP_MAX_TRIES; try++)
+	{
+		uptime += ARP_HOLD_TIMEOUT + 1;
+		check(holdFrame(&silent, try, 60) != 0, "tries", try);
+	}
+	uptime += ARP_HOLD_TIMEOUT + 1;
+	check(holdFrame(&silent, 0, 60) == 0, "unreachable after ARP_MAX_TRIES", 0);
+	check(holdFrame(&silent, 0, 60) == 0, "negative cache", 0);
+	uptime += ARP_NEGATIVE_TIMEOUT;
+	check(holdFrame(&silent, 0, 60) != 0, "negative cache timed out", 0);
+}
+
+static void testTooLong(void)
+{
+	uptime += 1000;
+	check(holdFrame(&router, 20, ARP_HOLD_LEN + 1) != 0, "ARP request for a long frame", 0);
+	replyFrom(&router, &routerMAC);
+	uint8_t markers[ARP_HOLD_SLOTS + 1];
+	check(heldFrames(markers) == 0, "long frame not parked", 0);
+}
+
+int main(void)
+{
+	testFramePerSlot();
+	testExpiry();
+	testUnreachable();
+	testTooLong();
+
+	if(failures)
+	{
+		printf("arp: %u failures\n", failures);
+		return EXIT_FAILURE;
+	}
+	printf("arp: OK\n");
+	return EXIT_SUCCESS;
+}
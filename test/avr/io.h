@@ -0,0 +1,22 @@
+#ifndef _AVR_IO_H_
+#define _AVR_IO_H_
+// Registers of the AVR used by the tested code, plain variables on the host (defined in stack.c)
+#include <stdint.h>
+
+extern volatile uint16_t TCNT1, OCR1A, OCR1B, ICR1;
+extern volatile uint8_t TIFR1, TIMSK1, SMCR;
+
+#define ICF1	5
+#define OCF1B	2
+#define OCF1A	1
+#define OCIE1B	2
+#define CS12	2
+#define CS11	1
+#define CS10	0
+#define SE	0
+
+#ifndef _BV
+#define _BV(bit) (1 << (bit))
+#endif
+
+#endif
@@ -0,0 +1,9 @@
+#ifndef _AVR_SLEEP_H_
+#define _AVR_SLEEP_H_
+// The main loop sleeps as long as the sleep enable bit stays set
+#include <avr/io.h>
+
+#define sleep_enable()	(SMCR |= _BV(SE))
+#define sleep_disable()	(SMCR &= (uint8_t)~_BV(SE))
+
+#endif
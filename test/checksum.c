@@ -0,0 +1,190 @@
+// Internet checksum: IP_Checksum against RFC 1071 and against a model of the AVR assembler,
+// incremental updates against a full recalculation
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "../Lib/IP.c"
+
+#define RUNS 1000000
+
+static uint32_t randomState = 1;
+static uint32_t random32(void)
+{	// xorshift32, the same sequence on every host
+	randomState ^= randomState << 13;
+	randomState ^= randomState >> 17;
+	randomState ^= randomState << 5;
+	return randomState;
+}
+
+static unsigned failures;
+static void check(bool ok, const char *test, unsigned run)
+{
+	if(!ok && failures++ < 10)
+		printf("FAIL %s, run %u\n", test, run);
+}
+
+// RFC 1071, 4.1: add 16 bit words and fold the carries at the end
+static uint16_t referenceChecksum(const uint8_t data[], uint16_t length)
+{
+	uint32_t sum = 0;
+	for(uint16_t i = 0; i + 1 < length; i += 2)
+		sum += (uint16_t)(data[i] | data[i + 1] << 8);	// Words in memory order, as on the AVR
+	if(length & 1)
+		sum += data[length - 1];
+	while(sum >> 16)
+		sum = (sum & 0xFFFF) + (sum >> 16);
+	return ~sum;
+}
+
+// IP_Checksum with IP_ChecksumWords as on the AVR: one adc per byte, carry kept across the chunks of 255 words
+static uint16_t avrChecksumWords(const uint8_t **data, uint8_t count, uint16_t sum)
+{
+	uint8_t low = sum, high = sum >> 8;
+	bool carry = false;					// clc
+	do
+	{
+		uint16_t add = low + *(*data)++ + carry;	// ld, adc %A0
+		low = add;
+		add = high + *(*data)++ + (add >> 8);		// ld, adc %B0
+		high = add;
+		carry = add >> 8;
+	} while(--count);					// dec keeps the carry
+	uint16_t add = low + carry;				// End around carry
+	low = add;
+	add = high + (add >> 8);
+	high = add;
+	low += add >> 8;
+	return low | high << 8;
+}
+
+static uint16_t avrChecksum(const uint8_t data[], uint16_t length)
+{
+	uint16_t length16 = length / 2;
+	uint16_t checksum = 0;
+	while(length16)
+	{
+		uint8_t count = (length16 > UINT8_MAX) ? UINT8_MAX : length16;
+		checksum = avrChecksumWords(&data, count, checksum);
+		length16 -= count;
+	}
+	if(length & 1)
+		IP_ChecksumAdd(&checksum, *data);
+	return ~checksum;
+}
+
+static void fill(uint8_t data[], uint16_t length, unsigned run)
+{
+	// Random data, all ones to provoke carries into the end around carry, or all zero
+	for(uint16_t i = 0; i < length; i++)
+		data[i] = (run % 4 == 1) ? 0xFF : (run % 4 == 2) ? 0 : random32();
+	if(run % 8 == 3 && length)
+		data[random32() % length] = random32();
+}
+
+static void testChecksum(void)
+{
+	static uint8_t data[PACKET_LEN_MAX + 1];
+	for(unsigned run = 0; run < RUNS / 10; run++)
+	{
+		// Cover the chunks of 255 words and odd lengths
+		uint16_t length = (run & 16) ? random32() % sizeof(data) : 2 * UINT8_MAX - 2 + random32() % 6;
+		uint8_t offset = random32() & 1;
+		fill(data + offset, length, run);
+
+		uint16_t reference = referenceChecksum(data + offset, length);
+		check(IP_Checksum(data + offset, length) == reference, "IP_Checksum", run);
+		check(avrChecksum(data + offset, length) == reference, "AVR model", run);
+	}
+}
+
+// Host timing of the portable code, for comparison the AVR assembler needs
+// 9 cycles per word (ld 2, adc 1, ld 2, adc 1, dec 1, brne 2), that is 4.5 cycles per byte.
+static void benchmark(void)
+{
+	static uint8_t data[PACKET_LEN_MAX];
+	fill(data, sizeof(data), 0);
+
+	volatile uint16_t sink;
+	const unsigned loops = 100000;
+	clock_t start = clock();
+	for(unsigned i = 0; i < loops; i++)
+		sink = IP_Checksum(data, sizeof(data));
+	clock_t middle = clock();
+	for(unsigned i = 0; i < loops; i++)
+		sink = referenceChecksum(data, sizeof(data));
+	clock_t end = clock();
+	(void)sink;
+
+	double bytes = (double)loops * sizeof(data);
+	printf("checksum: IP_Checksum %.2f ns/byte, RFC 1071 loop %.2f ns/byte\n",
+	       (middle - start) * 1e9 / CLOCKS_PER_SEC / bytes, (end - middle) * 1e9 / CLOCKS_PER_SEC / bytes);
+}
+
+// Replace one word of a buffer with a valid checksum like IP_ProcessPacket does
+static void testUpdate(void)
+{
+	for(unsigned run = 0; run < RUNS; run++)
+	{
+		uint16_t words[10];	// IP header sized
+		for(uint8_t i = 0; i < ARRAY_SIZE(words); i++)
+			words[i] = random32();
+		// Some all zero and all one words for the corner cases of one's complement
+		if(run & 1)
+			words[random32() % ARRAY_SIZE(words)] = (run & 2) ? 0xFFFF : 0;
+		words[5] = 0;
+		words[5] = IP_Checksum(words, sizeof(words));
+
+		uint8_t position = random32() % ARRAY_SIZE(words);
+		if(position == 5)
+			continue;
+		uint16_t newWord = (run & 4) ? random32() : ((run & 8) ? 0xFFFF : 0);
+		uint16_t oldSum = ~IP_Checksum(&words[position], sizeof(uint16_t));
+		uint16_t newSum = ~IP_Checksum(&newWord, sizeof(uint16_t));
+		words[position] = newWord;
+		IP_ChecksumUpdate(&words[5], oldSum, newSum);
+
+		// The receiver only checks that the header sums up to -0
+		check(IP_Checksum(words, sizeof(words)) == 0, "IP_ChecksumUpdate", run);
+	}
+}
+
+// Replace a broadcast destination by our own address, as in the reflection of IP_ProcessPacket
+static void testAddressUpdate(void)
+{
+	for(unsigned run = 0; run < RUNS; run++)
+	{
+		IP_Header_t header;
+		uint8_t *bytes = (uint8_t *)&header;
+		for(uint8_t i = 0; i < sizeof(header); i++)
+			bytes[i] = random32();
+		header.DestinationAddress = (run & 1) ? BroadcastIPAddress : random32();
+		header.Checksum = 0;
+		header.Checksum = IP_Checksum(&header, sizeof(header));
+
+		const IP_Address_t destinationAddress = header.DestinationAddress;
+		header.DestinationAddress = header.SourceAddress;
+		header.SourceAddress = OwnIPAddress;
+		uint16_t oldSum = ~IP_Checksum(&destinationAddress, sizeof(IP_Address_t));
+		uint16_t newSum = ~IP_Checksum(&OwnIPAddress, sizeof(IP_Address_t));
+		IP_ChecksumUpdate(&header.Checksum, oldSum, newSum);
+
+		check(IP_Checksum(&header, sizeof(header)) == 0, "address update", run);
+	}
+}
+
+int main(void)
+{
+	testChecksum();
+	testUpdate();
+	testAddressUpdate();
+	benchmark();
+
+	if(failures)
+	{
+		printf("checksum: %u failures\n", failures);
+		return EXIT_FAILURE;
+	}
+	printf("checksum: OK\n");
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,253 @@
+// Receive checks of net/PacketCheck.c: the checksum summed up in the USB interrupt against IP_Checksum,
+// token buckets of the ingress policer, destination MAC filter
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#define IP_MULTICAST	239, 192, 0, 40	// Checked by the MAC filter
+#include "resources.h"
+#include "../net/network.h"
+#include "clock.h"
+
+// The frame is read from the USB endpoint register one byte after the other
+const uint8_t *endpoint;
+#define UEDATX (*endpoint++)
+
+// The policer runs on the monotonic time, it wraps during testPolice
+Time_t monotonic = -TIME_SECONDS(50);
+Time_t clock_getMonotonic(void)
+{
+	return monotonic;
+}
+
+#include "../net/PacketCheck.c"
+
+#define RUNS 1000000
+
+static uint32_t randomState = 1;
+static uint32_t random32(void)
+{	// xorshift32, the same sequence on every host
+	randomState ^= randomState << 13;
+	randomState ^= randomState >> 17;
+	randomState ^= randomState << 5;
+	return randomState;
+}
+
+static unsigned failures;
+static void check(bool ok, const char *test, unsigned run)
+{
+	if(!ok && failures++ < 10)
+		printf("FAIL %s, run %u\n", test, run);
+}
+
+static void put16(uint8_t *data, uint16_t value)
+{
+	data[0] = value >> 8;
+	data[1] = value;
+}
+
+// Sum as in the receive interrupt of USB.c: all words from the IP header on in memory order, a last odd byte alone
+static uint32_t interruptSum(const uint8_t frame[], uint16_t length)
+{
+	uint32_t sum = 0;
+	for(uint16_t i = 14; i + 1 < length; i += 2)
+		sum += (uint16_t)frame[i + 1] << 8 | frame[i];
+	if(length & 1)
+		sum += frame[length - 1];
+	return sum;
+}
+
+// Checks of the receiver, done with IP_Checksum over the IP header and over the ICMP message
+// or the UDP pseudo header and datagram
+static bool referenceValid(const uint8_t frame[], uint16_t length)
+{
+	const uint8_t *IP = frame + 14;
+	if(IP_Checksum(IP, 20))
+		return false;
+	if(IP[9] != IP_PROTOCOL_UDP)
+		return IP_Checksum(IP + 20, length - 14 - 20) == 0;
+	if(IP[20 + 6] == 0 && IP[20 + 7] == 0)
+		return true;
+
+	uint8_t pseudo[12 + PACKET_LEN_MAX];
+	uint16_t udpLength = length - 14 - 20;
+	memcpy(pseudo, IP + 12, 8);
+	pseudo[8] = 0;
+	pseudo[9] = IP_PROTOCOL_UDP;
+	put16(pseudo + 10, udpLength);
+	memcpy(pseudo + 12, IP + 20, udpLength);
+	return IP_Checksum(pseudo, 12 + udpLength) == 0;
+}
+
+// Random UDP or ICMP frame with valid checksums
+static uint16_t randomFrame(uint8_t frame[], unsigned run)
+{
+	uint16_t length = 14 + 20 + 8 + random32() % (PACKET_LEN_MAX - 14 - 20 - 8 + 1);
+	for(uint16_t i = 0; i < length; i++)
+		frame[i] = random32();
+	put16(frame + 12, ETHERTYPE_IPV4);
+
+	uint8_t *IP = frame + 14;
+	IP[0] = IP_VERSION_IHL;
+	put16(IP + 2, length - 14);
+	IP[9] = (run & 1) ? IP_PROTOCOL_ICMP : IP_PROTOCOL_UDP;
+	// High addresses make the pseudo header words carry, like the SNTP server 192.168.200.3
+	if(run & 2)
+	{
+		memset(IP + 12, 0xFF, 8);
+		IP[12] = 0xC0, IP[13] = 0xA8, IP[14] = 0xC8, IP[15] = 0x03;
+	}
+	put16(IP + 10, 0);
+	uint16_t headerSum = IP_Checksum(IP, 20);
+	memcpy(IP + 10, &headerSum, 2);
+
+	if(IP[9] == IP_PROTOCOL_UDP)
+	{
+		uint8_t *UDP = IP + 20;
+		put16(UDP + 4, length - 14 - 20);
+		put16(UDP + 6, 0);
+		if(!(run & 4))
+		{
+			uint8_t pseudo[12 + PACKET_LEN_MAX];
+			uint16_t udpLength = length - 14 - 20;
+			memcpy(pseudo, IP + 12, 8);
+			pseudo[8] = 0;
+			pseudo[9] = IP_PROTOCOL_UDP;
+			put16(pseudo + 10, udpLength);
+			memcpy(pseudo + 12, UDP, udpLength);
+			uint16_t sum = IP_Checksum(pseudo, 12 + udpLength);
+			if(!sum)
+				sum = 0xFFFF;
+			memcpy(UDP + 6, &sum, 2);
+		}
+	} else {
+		// ICMP checksum over the whole message
+		uint8_t *ICMP = IP + 20;
+		put16(ICMP + 2, 0);
+		uint16_t sum = IP_Checksum(ICMP, length - 14 - 20);
+		memcpy(ICMP + 2, &sum, 2);
+	}
+	return length;
+}
+
+static void testChecksums(void)
+{
+	static uint8_t frame[PACKET_LEN_MAX];
+	for(unsigned run = 0; run < RUNS / 10; run++)
+	{
+		uint16_t length = randomFrame(frame, run);
+		if(run & 8)	// Corrupt one byte of the IP header or payload
+			frame[14 + random32() % (length - 14)] ^= 1 << (random32() % 8);
+
+		check(USB_Check_Checksums(frame, interruptSum(frame, length)) == referenceValid(frame, length), "USB_Check_Checksums", run);
+	}
+}
+
+// Start of an ARP frame from another host, as far as USB_Read24Byte_Check_GetLength reads it
+static uint16_t receiveARP(bool broadcast, ARP_Operation_t operation)
+{
+	static uint8_t frame[24];
+	const uint8_t start[24] = {
+		broadcast ? 0xFF : GETBYTE_ARRAY(0, MAC_OWN), broadcast ? 0xFF : GETBYTE_ARRAY(1, MAC_OWN),
+		broadcast ? 0xFF : GETBYTE_ARRAY(2, MAC_OWN), broadcast ? 0xFF : GETBYTE_ARRAY(3, MAC_OWN),
+		broadcast ? 0xFF : GETBYTE_ARRAY(4, MAC_OWN), broadcast ? 0xFF : GETBYTE_ARRAY(5, MAC_OWN),
+		0x02, 0x00, 0x00, 0x00, 0x00, 0x01,
+		GETBYTE(1, ETHERTYPE_ARP), GETBYTE(0, ETHERTYPE_ARP),
+		0x00, 0x01, 0x08, 0x00, 6, 4,
+		GETBYTE(1, operation), GETBYTE(0, operation),
+		0x02, 0x00,
+	};
+	uint8_t buffer[24];
+	memcpy(frame, start, sizeof(frame));
+	endpoint = frame;
+	return USB_Read24Byte_Check_GetLength(buffer);
+}
+
+static void testPolice(void)
+{
+	// The buckets start full: a burst passes at once, then the class is dropped
+	for(uint8_t i = 0; i < POLICE_BURST_ARP_REQUEST; i++)
+		check(receiveARP(true, ARP_OPERATION_REQUEST), "burst of requests", i);
+	check(!receiveARP(true, ARP_OPERATION_REQUEST), "request over the burst", 0);
+	check(PoliceDropped[POLICE_ARP_REQUEST] == 1, "dropped requests counted", 0);
+
+	// A flood of broadcast requests does not block replies
+	for(uint8_t i = 0; i < POLICE_BURST_ARP; i++)
+		check(receiveARP(false, ARP_OPERATION_REPLY), "replies during a flood of requests", i);
+	check(!receiveARP(false, ARP_OPERATION_REPLY), "reply over the burst", 0);
+
+	// Refill within the second: one token after 1/rate seconds, not only when the second changes
+	monotonic += TIME_SECONDS(1) / POLICE_RATE_ARP_REQUEST - 1;
+	check(!receiveARP(true, ARP_OPERATION_REQUEST), "request before the refill", 0);
+	monotonic += 1 << (TIME_FRACTION_BITS - 8);
+	check(receiveARP(true, ARP_OPERATION_REQUEST), "request after the refill", 0);
+	check(!receiveARP(true, ARP_OPERATION_REQUEST), "only one token refilled", 0);
+
+	// Constant rate over a long time, fractions of tokens add up
+	unsigned passed = 0;
+	for(unsigned step = 0; step < 100 * 64; step++)
+	{
+		monotonic += TIME_SECONDS(1) / 64;
+		passed += receiveARP(true, ARP_OPERATION_REQUEST) != 0;
+	}
+	check(passed >= 99 * POLICE_RATE_ARP_REQUEST && passed <= 100 * POLICE_RATE_ARP_REQUEST + 1, "rate over 100 s", passed);
+
+	// After a long pause the bucket holds the burst and not more
+	monotonic += TIME_SECONDS(1000);
+	passed = 0;
+	for(uint8_t i = 0; i < 2 * POLICE_BURST_ARP_REQUEST; i++)
+		passed += receiveARP(true, ARP_OPERATION_REQUEST) != 0;
+	check(passed == POLICE_BURST_ARP_REQUEST, "burst after a pause", passed);
+}
+
+// Start of an IPv4/UDP frame to the destination MAC, as far as USB_Read24Byte_Check_GetLength reads it
+static uint16_t receiveUDP(const uint8_t destination[6])
+{
+	static uint8_t frame[24];
+	const uint8_t start[24 - 6] = {
+		0x02, 0x00, 0x00, 0x00, 0x00, 0x01,
+		GETBYTE(1, ETHERTYPE_IPV4), GETBYTE(0, ETHERTYPE_IPV4),
+		IP_VERSION_IHL, 0, 0, 20 + 8 + 4, 0, 0, GETBYTE(1, IP_FLAGS_DONTFRAGMENT), 0, 1, IP_PROTOCOL_UDP,
+	};
+	uint8_t buffer[24];
+	memcpy(frame, destination, 6);
+	memcpy(frame + 6, start, sizeof(start));
+	endpoint = frame;
+	return USB_Read24Byte_Check_GetLength(buffer);
+}
+
+static void testMulticastMAC(void)
+{
+	static const struct {
+		uint8_t MAC[6];
+		bool accepted;
+	} cases[] = {
+		{{0x01, 0x00, 0x5E, 0x40, 0x00, 0x28}, true},	// 239.192.0.40
+		{{0x01, 0x00, 0x5E, 0x00, 0x00, 0x01}, true},	// 224.0.0.1, IGMP queries
+		{{0x01, 0x00, 0x5E, 0x40, 0x00, 0x29}, false},	// Other groups
+		{{0x01, 0x00, 0x5E, 0x00, 0x00, 0x28}, false},
+		{{0x01, 0x00, 0x5E, 0xC0, 0x00, 0x28}, false},	// Bit 24 is not part of the group
+		{{0x01, 0x00, 0x5E, 0x00, 0x00, 0x02}, false},	// All routers
+		{{0x01, 0x00, 0x5F, 0x40, 0x00, 0x28}, false},
+		{{0x01, 0x80, 0xC2, 0x00, 0x00, 0x00}, false},	// Spanning tree
+		{{MAC_OWN}, true},
+		{{MAC_BROADCAST}, true},
+	};
+	for(uint8_t i = 0; i < ARRAY_SIZE(cases); i++)
+		check((receiveUDP(cases[i].MAC) != 0) == cases[i].accepted, "multicast MAC", i);
+}
+
+int main(void)
+{
+	testChecksums();
+	testPolice();
+	testMulticastMAC();
+
+	if(failures)
+	{
+		printf("packetcheck: %u failures\n", failures);
+		return EXIT_FAILURE;
+	}
+	printf("packetcheck: OK\n");
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,299 @@
+// Worklist and timer heap of checkRules against a full sweep over all rules, on random rule graphs
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include "clock.h"
+
+typedef uint32_t ruleValue_t;
+typedef uint8_t ruleNum_t;
+typedef enum {ruleUnknown, ruleOK, ruleChanged, ruleSendLater} ruleOK_t;
+typedef enum {ptLogic, ptRelay, ptTimer} ruleType_t;
+
+// Only the fields ruleQueue.h looks at
+typedef struct {
+	ruleType_t	type;
+	ruleNum_t	dependIndex;
+	union {
+		struct {
+			ruleNum_t second, third, fourth;
+		} logic;
+		struct {
+			ruleNum_t interlock;
+		} hw;
+	} data;
+} ruleData_t;
+
+typedef struct {
+	Time_t		timer;
+	ruleValue_t	value;
+	ruleOK_t	ok;
+} ruleState_t;
+
+#define RULES	250
+static ruleData_t ruleData[RULES];
+static ruleState_t ruleState[] = {[0 ... RULES-1] = {.timer = TIME_SECONDS(5)}};
+#include "ruleQueue.h"
+
+// State of the reference, which checks every rule in each run
+static ruleState_t refState[RULES];
+static bool refRunning[RULES];
+
+static unsigned failures;
+static void check(bool ok, const char *test, unsigned run)
+{
+	if(!ok && failures++ < 10)
+		printf("FAIL %s, %u\n", test, run);
+}
+
+static uint32_t state32 = 2463534242u;
+static uint32_t random32(void)
+{
+	state32 ^= state32 << 13;
+	state32 ^= state32 >> 17;
+	state32 ^= state32 << 5;
+	return state32;
+}
+
+static uint32_t hash(uint32_t a, uint32_t b)
+{
+	a ^= b * 2654435761u;
+	a ^= a >> 15;
+	return a * 2246822519u;
+}
+
+// The same evaluation for both. Returns whether the timer of the rule runs, until *timer then.
+static bool evaluate(const ruleState_t state[], ruleNum_t rule, Time_t now, bool changed, ruleValue_t *value, Time_t *timer)
+{
+	const ruleData_t *data = &ruleData[rule];
+	ruleValue_t dependValue = state[data->dependIndex].value;
+	switch(data->type)
+	{
+		case ptLogic:
+			*value = dependValue | (state[data->data.logic.second].value ^ state[data->data.logic.third].value ^ state[data->data.logic.fourth].value);
+			return false;
+		case ptRelay:
+			*value = (dependValue & 1) && !(state[data->data.hw.interlock].value & 1);
+			return false;
+		default:
+			*value = hash(dependValue + changed, now) % 3;
+			*timer = now + 1 + hash(rule, now) % TIME_SECONDS(60);
+			return true;
+	}
+}
+
+static bool refCheckDependency(ruleNum_t dependIndex, bool *changed)
+{
+	if(refState[dependIndex].ok == ruleUnknown) return true;
+	if(refState[dependIndex].ok == ruleChanged) *changed = true;
+	return false;
+}
+
+static void refRun(Time_t now)
+{
+	refState[0].ok = ruleOK;
+	for(uint16_t rule = 0; rule < RULES; rule++)
+	{
+		bool changed = false;
+		bool expired = refRunning[rule] && !TIME_BEFORE(now, refState[rule].timer);
+		if(refCheckDependency(ruleData[rule].dependIndex, &changed) ||
+		   (ruleData[rule].type == ptLogic &&
+		    (refCheckDependency(ruleData[rule].data.logic.second, &changed) ||
+		     refCheckDependency(ruleData[rule].data.logic.third, &changed) ||
+		     refCheckDependency(ruleData[rule].data.logic.fourth, &changed))))
+		{
+			refState[rule].ok = ruleUnknown;
+			if(expired)
+				refState[rule].timer = now + TIME_SECONDS(1);
+			continue;
+		}
+		if(ruleData[rule].type == ptRelay && ruleData[rule].data.hw.interlock &&
+		   refState[ruleData[rule].data.hw.interlock].ok == ruleChanged)
+			changed = true;
+		if(!changed && !expired)
+			continue;
+
+		if(refState[rule].ok != ruleSendLater)
+			refState[rule].ok = ruleOK;
+		ruleValue_t value;
+		refRunning[rule] = evaluate(refState, rule, now, changed, &value, &refState[rule].timer);
+		if(refState[rule].value != value)
+		{
+			refState[rule].value = value;
+			refState[rule].ok = ruleChanged;
+		}
+	}
+}
+
+// The part of checkRules which decides which rules are checked
+static unsigned visits;
+static void queueRun(Time_t now)
+{
+	setOK(0, ruleOK);
+	uint8_t expired[ruleBitmapSize] = {0};
+	queuePendingRules(now, expired);
+
+	for(uint16_t next = nextRule(rulePending, 0); next < RULES; next = nextRule(rulePending, next + 1))
+	{
+		ruleNum_t rule = (ruleNum_t)next;
+		rulePending[rule / 8] &= ~_BV(rule % 8);
+		visits++;
+
+		bool changed = false;
+		if(checkInputs(rule, &changed))
+		{
+			setOK(rule, ruleUnknown);
+			if(expired[rule / 8] & _BV(rule % 8))
+				setTimer(rule, now + TIME_SECONDS(1));
+			continue;
+		}
+		if(ruleData[rule].type == ptRelay && ruleData[rule].data.hw.interlock &&
+		   ruleState[ruleData[rule].data.hw.interlock].ok == ruleChanged)
+			changed = true;
+		if(!changed && !(expired[rule / 8] & _BV(rule % 8)))
+			continue;
+
+		if(ruleState[rule].ok != ruleSendLater)
+			setOK(rule, ruleOK);
+		ruleValue_t value;
+		Time_t timer;
+		if(evaluate(ruleState, rule, now, changed, &value, &timer))
+			setTimer(rule, timer);
+		else
+			clearTimer(rule);
+		if(ruleState[rule].value != value)
+		{
+			ruleState[rule].value = value;
+			setOK(rule, ruleChanged);
+		}
+	}
+}
+
+static ruleNum_t randomRule(void)
+{
+	return (ruleNum_t)(random32() % RULES);
+}
+
+// Mostly inputs with a lower index, a few from further down, which may form loops
+static ruleNum_t randomInput(ruleNum_t rule)
+{
+	if(!rule || random32() % 100 == 0)
+		return randomRule();
+	return (ruleNum_t)(random32() % rule);
+}
+
+static void randomRules(void)
+{
+	for(uint16_t rule = 0; rule < RULES; rule++)
+	{
+		ruleData_t *data = &ruleData[rule];
+		uint32_t type = random32() % 8;
+		data->type = type < 6 ? ptLogic : type < 7 ? ptTimer : ptRelay;
+		data->dependIndex = randomInput(rule);
+		if(data->type == ptRelay)
+			data->data.hw.interlock = random32() % 2 ? 0 : randomInput(rule);
+		else
+		{
+			data->data.logic.second = random32() % 2 ? 0 : randomInput(rule);
+			data->data.logic.third = random32() % 3 ? 0 : randomInput(rule);
+			data->data.logic.fourth = random32() % 4 ? 0 : randomInput(rule);
+		}
+	}
+	// Rule 0 is the constant input, like in the configurations
+	ruleData[0] = (ruleData_t){.type = ptLogic};
+
+	// Rebuild what the constructors did for the empty table
+	memset(ruleDependentsStart, 0, sizeof(ruleDependentsStart));
+	initDependents();
+	while(ruleTimerCount)
+		clearTimer(ruleTimerHeap[0]);
+	memset(ruleHot, 0xFF, sizeof(ruleHot));
+	memset(rulePending, 0, sizeof(rulePending));
+	for(ruleNum_t rule = 0; rule < RULES; rule++)
+	{
+		ruleState[rule] = (ruleState_t){.timer = TIME_SECONDS(5)};
+		setTimer(rule, ruleState[rule].timer);
+		refRunning[rule] = true;
+	}
+	memcpy(refState, ruleState, sizeof(refState));
+}
+
+static void testGraph(unsigned graph)
+{
+	randomRules();
+
+	// Starts shortly before the monotonic time wraps
+	Time_t now = -TIME_SECONDS(60);
+	for(unsigned run = 0; run < 2000; run++)
+	{
+		now += random32() % TIME_SECONDS(1);
+
+		// Received packets and sendChangedRules change states and timers in between
+		for(uint32_t events = random32() % 4; events--;)
+		{
+			ruleNum_t rule = randomRule();
+			ruleOK_t ok = random32() % 16 ? ruleOK + random32() % 3 : ruleUnknown;
+			refState[rule].ok = ok;
+			setOK(rule, ok);
+			if(random32() % 2)
+			{
+				refState[rule].value++;
+				ruleState[rule].value++;
+			}
+			if(random32() % 4 == 0)
+			{
+				refState[rule].timer = now + random32() % TIME_SECONDS(3);
+				refRunning[rule] = true;
+				setTimer(rule, refState[rule].timer);
+			}
+		}
+		if(random32() % 5 == 0)
+			for(ruleNum_t rule = 0; rule < RULES; rule++)
+				if(refState[rule].ok >= ruleChanged)
+				{
+					ruleOK_t ok = random32() % 2 ? ruleOK : ruleSendLater;
+					refState[rule].ok = ok;
+					setOK(rule, ok);
+				}
+
+		refRun(now);
+		queueRun(now);
+
+		bool same = true;
+		Time_t first = 0;
+		bool running = false;
+		for(ruleNum_t rule = 0; rule < RULES; rule++)
+		{
+			same &= refState[rule].ok == ruleState[rule].ok && refState[rule].value == ruleState[rule].value;
+			same &= refRunning[rule] == timerRunning(rule);
+			if(!refRunning[rule])
+				continue;
+			same &= refState[rule].timer == ruleState[rule].timer;
+			if(!running || TIME_BEFORE(refState[rule].timer, first))
+				first = refState[rule].timer;
+			running = true;
+		}
+		check(same, "same states as the sweep", graph * 10000 + run);
+		check(running == (ruleTimerCount != 0) && (!running || ruleState[ruleTimerHeap[0]].timer == first), "first timer on top of the heap", graph * 10000 + run);
+		// An expired timer left over would keep waking the main loop
+		check(!running || TIME_BEFORE(now, first), "no timer in the past", graph * 10000 + run);
+		if(failures)
+			return;
+	}
+}
+
+int main(void)
+{
+	const unsigned graphs = 20;
+	for(unsigned graph = 0; graph < graphs; graph++)
+		testGraph(graph);
+
+	printf("rulequeue: %.1f of %u rules checked per run\n", visits / (graphs * 2000.0), RULES);
+	if(failures)
+	{
+		printf("rulequeue: %u failures\n", failures);
+		return EXIT_FAILURE;
+	}
+	printf("rulequeue: OK\n");
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,39 @@
+// Addresses and the parts of the network stack the tested files refer to, but don't use
+#include "IP.h"
+#include "UDP.h"
+#include "ICMP.h"
+#include "Ethernet.h"
+#include <avr/io.h>
+
+volatile uint16_t TCNT1, OCR1A, OCR1B, ICR1;
+volatile uint8_t TIFR1, TIMSK1, SMCR;
+
+const MAC_Address_t OwnMACAddress = {{MAC_OWN}};
+const MAC_Address_t BroadcastMACAddress = {{MAC_BROADCAST}};
+const IP_Address_t OwnIPAddress = CPU_TO_BE32(0xC0A8C828);
+const IP_Address_t BroadcastIPAddress = CPU_TO_BE32(0xC0A8C8FF);
+const IP_Address_t RouterIPAddress = CPU_TO_BE32(0xC0A8C803);
+
+bool ICMP_ProcessPacket(uint8_t packet[] ATTR_MAYBE_UNUSED)
+{
+	return false;
+}
+
+bool UDP_ProcessPacket(uint8_t packet[] ATTR_MAYBE_UNUSED, const IP_Address_t *sourceIP ATTR_MAYBE_UNUSED, uint16_t length ATTR_MAYBE_UNUSED)
+{
+	return false;
+}
+
+void UDP_ChecksumUpdate(uint8_t packet[] ATTR_MAYBE_UNUSED, uint16_t oldSum ATTR_MAYBE_UNUSED, uint16_t newSum ATTR_MAYBE_UNUSED)
+{
+}
+
+uint16_t Ethernet_GenerateUnicast(uint8_t packet[] ATTR_MAYBE_UNUSED, const IP_Address_t *destinationIP ATTR_MAYBE_UNUSED, Ethertype_t ethertype ATTR_MAYBE_UNUSED, uint16_t payloadLength)
+{
+	return payloadLength;
+}
+
+uint16_t Ethernet_GenerateBroadcast(uint8_t packet[] ATTR_MAYBE_UNUSED, Ethertype_t ethertype ATTR_MAYBE_UNUSED, uint16_t payloadLength)
+{
+	return ETHERNET_HEADER_LEN + payloadLength;
+}
@@ -0,0 +1,84 @@
+// Sunrise and sunset: sun_calculate against the double precision table of sunref.py, and its cost per call
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <time.h>
+#ifndef ONE_DAY
+#define ONE_DAY 86400	// avr-libc, time_t counts from 2000-01-01
+#endif
+#include "../sun.c"
+#include "sunref.h"
+
+#define MAX_ERROR	60	// Seconds, for rise/set and civil twilight up to 60° latitude
+#define RUNS		1000000
+
+static unsigned failures;
+static void check(bool ok, const char *test, unsigned run)
+{
+	if(!ok && failures++ < 10)
+		printf("FAIL %s, run %u\n", test, run);
+}
+
+static long difference(time_t a, time_t b)
+{
+	return a > b ? (long)(a - b) : (long)(b - a);
+}
+
+static void testReference(void)
+{
+	long maxError = 0, sumError = 0;
+	for(unsigned i = 0; i < ARRAY_SIZE(sunReference); i++)
+	{
+		time_t rise, set;
+		SunDay_t result = sun_calculate(sunReference[i].day, sunReference[i].latitude, sunReference[i].longitude, sunReference[i].twilight, &rise, &set);
+		check(result == SunNormal, "rise and set", i);
+		if(result != SunNormal)
+			continue;
+
+		long error = MAX(difference(rise, sunReference[i].rise), difference(set, sunReference[i].set));
+		check(error <= MAX_ERROR, "error within MAX_ERROR", i);
+		maxError = MAX(maxError, error);
+		sumError += error;
+	}
+	printf("sun: error %ld s maximum, %.1f s mean over %u cases\n", maxError, (double)sumError / ARRAY_SIZE(sunReference), (unsigned)ARRAY_SIZE(sunReference));
+}
+
+static void testPolar(void)
+{
+	time_t rise, set;
+	uint16_t summer = 9667, winter = 9850;	// 2026-06-21 and 2026-12-21
+	check(sun_calculate(summer, SUN_POSITION(80), 0, SunRiseSet, &rise, &set) == SunAlwaysUp, "polar day", 0);
+	check(sun_calculate(winter, SUN_POSITION(80), 0, SunRiseSet, &rise, &set) == SunAlwaysDown, "polar night", 0);
+	check(sun_calculate(summer, SUN_POSITION(-80), 0, SunRiseSet, &rise, &set) == SunAlwaysDown, "polar night in the south", 0);
+	check(sun_calculate(summer, SUN_POSITION(60), 0, SunAstronomical, &rise, &set) == SunAlwaysUp, "no astronomical night", 0);
+}
+
+static void benchmark(void)
+{
+	volatile time_t sink;
+	time_t rise = 0, set = 0;
+	clock_t start = clock();
+	for(unsigned run = 0; run < RUNS; run++)
+	{
+		if(sun_calculate(9517 + run % 3650, SUN_POSITION(51), SUN_POSITION(10), run % 4, &rise, &set) == SunNormal)
+			sink = rise + set;
+	}
+	(void)sink;
+	double seconds = (double)(clock() - start) / CLOCKS_PER_SEC;
+	printf("sun: sun_calculate %.0f ns per call\n", seconds * 1e9 / RUNS);
+}
+
+int main(void)
+{
+	testReference();
+	testPolar();
+	benchmark();
+
+	if(failures)
+	{
+		printf("sun: %u failures\n", failures);
+		return EXIT_FAILURE;
+	}
+	printf("sun: OK\n");
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,428 @@
+// Generated by sunref.py, do not edit
+static const struct {
+	uint16_t	day;
+	int16_t		latitude, longitude;	// SUN_POSITION
+	SunTwilight_t	twilight;
+	time_t		rise, set;
+} sunReference[] = {
+	{9517, SUN_POSITION(-60), SUN_POSITION(-122.5), SunRiseSet, 822310692, 822373586},
+	{9517, SUN_POSITION(-60), SUN_POSITION(-122.5), SunCivil, 822306625, 822377653},
+	{9517, SUN_POSITION(-60), SUN_POSITION(10.0), SunRiseSet, 822278834, 822341831},
+	{9517, SUN_POSITION(-60), SUN_POSITION(10.0), SunCivil, 822274743, 822345923},
+	{9517, SUN_POSITION(-60), SUN_POSITION(139.75), SunRiseSet, 822247638, 822310735},
+	{9517, SUN_POSITION(-60), SUN_POSITION(139.75), SunCivil, 822243522, 822314851},
+	{9517, SUN_POSITION(-45), SUN_POSITION(-122.5), SunRiseSet, 822315134, 822369144},
+	{9517, SUN_POSITION(-45), SUN_POSITION(-122.5), SunCivil, 822313046, 822371232},
+	{9517, SUN_POSITION(-45), SUN_POSITION(10.0), SunRiseSet, 822283304, 822337362},
+	{9517, SUN_POSITION(-45), SUN_POSITION(10.0), SunCivil, 822281213, 822339453},
+	{9517, SUN_POSITION(-45), SUN_POSITION(139.75), SunRiseSet, 822252134, 822306239},
+	{9517, SUN_POSITION(-45), SUN_POSITION(139.75), SunCivil, 822250040, 822308333},
+	{9517, SUN_POSITION(-30), SUN_POSITION(-122.5), SunRiseSet, 822317399, 822366879},
+	{9517, SUN_POSITION(-30), SUN_POSITION(-122.5), SunCivil, 822315815, 822368463},
+	{9517, SUN_POSITION(-30), SUN_POSITION(10.0), SunRiseSet, 822285580, 822335086},
+	{9517, SUN_POSITION(-30), SUN_POSITION(10.0), SunCivil, 822283994, 822336672},
+	{9517, SUN_POSITION(-30), SUN_POSITION(139.75), SunRiseSet, 822254420, 822303953},
+	{9517, SUN_POSITION(-30), SUN_POSITION(139.75), SunCivil, 822252833, 822305540},
+	{9517, SUN_POSITION(-15), SUN_POSITION(-122.5), SunRiseSet, 822318985, 822365293},
+	{9517, SUN_POSITION(-15), SUN_POSITION(-122.5), SunCivil, 822317604, 822366674},
+	{9517, SUN_POSITION(-15), SUN_POSITION(10.0), SunRiseSet, 822287173, 822333493},
+	{9517, SUN_POSITION(-15), SUN_POSITION(10.0), SunCivil, 822285791, 822334875},
+	{9517, SUN_POSITION(-15), SUN_POSITION(139.75), SunRiseSet, 822256020, 822302352},
+	{9517, SUN_POSITION(-15), SUN_POSITION(139.75), SunCivil, 822254638, 822303735},
+	{9517, SUN_POSITION(0), SUN_POSITION(-122.5), SunRiseSet, 822320327, 822363952},
+	{9517, SUN_POSITION(0), SUN_POSITION(-122.5), SunCivil, 822319008, 822365271},
+	{9517, SUN_POSITION(0), SUN_POSITION(10.0), SunRiseSet, 822288520, 822332145},
+	{9517, SUN_POSITION(0), SUN_POSITION(10.0), SunCivil, 822287201, 822333465},
+	{9517, SUN_POSITION(0), SUN_POSITION(139.75), SunRiseSet, 822257374, 822300999},
+	{9517, SUN_POSITION(0), SUN_POSITION(139.75), SunCivil, 822256053, 822302319},
+	{9517, SUN_POSITION(15), SUN_POSITION(-122.5), SunRiseSet, 822321651, 822362627},
+	{9517, SUN_POSITION(15), SUN_POSITION(-122.5), SunCivil, 822320288, 822363991},
+	{9517, SUN_POSITION(15), SUN_POSITION(10.0), SunRiseSet, 822289850, 822330815},
+	{9517, SUN_POSITION(15), SUN_POSITION(10.0), SunCivil, 822288486, 822332179},
+	{9517, SUN_POSITION(15), SUN_POSITION(139.75), SunRiseSet, 822258710, 822299663},
+	{9517, SUN_POSITION(15), SUN_POSITION(139.75), SunCivil, 822257345, 822301028},
+	{9517, SUN_POSITION(30), SUN_POSITION(-122.5), SunRiseSet, 822323177, 822361101},
+	{9517, SUN_POSITION(30), SUN_POSITION(-122.5), SunCivil, 822321643, 822362635},
+	{9517, SUN_POSITION(30), SUN_POSITION(10.0), SunRiseSet, 822291384, 822329282},
+	{9517, SUN_POSITION(30), SUN_POSITION(10.0), SunCivil, 822289848, 822330817},
+	{9517, SUN_POSITION(30), SUN_POSITION(139.75), SunRiseSet, 822260250, 822298123},
+	{9517, SUN_POSITION(30), SUN_POSITION(139.75), SunCivil, 822258714, 822299659},
+	{9517, SUN_POSITION(45), SUN_POSITION(-122.5), SunRiseSet, 822325299, 822358979},
+	{9517, SUN_POSITION(45), SUN_POSITION(-122.5), SunCivil, 822323364, 822360914},
+	{9517, SUN_POSITION(45), SUN_POSITION(10.0), SunRiseSet, 822293516, 822327149},
+	{9517, SUN_POSITION(45), SUN_POSITION(10.0), SunCivil, 822291579, 822329086},
+	{9517, SUN_POSITION(45), SUN_POSITION(139.75), SunRiseSet, 822262393, 822295980},
+	{9517, SUN_POSITION(45), SUN_POSITION(139.75), SunCivil, 822260454, 822297919},
+	{9517, SUN_POSITION(51), SUN_POSITION(-122.5), SunRiseSet, 822326521, 822357757},
+	{9517, SUN_POSITION(51), SUN_POSITION(-122.5), SunCivil, 822324290, 822359988},
+	{9517, SUN_POSITION(51), SUN_POSITION(10.0), SunRiseSet, 822294745, 822325921},
+	{9517, SUN_POSITION(51), SUN_POSITION(10.0), SunCivil, 822292511, 822328155},
+	{9517, SUN_POSITION(51), SUN_POSITION(139.75), SunRiseSet, 822263628, 822294745},
+	{9517, SUN_POSITION(51), SUN_POSITION(139.75), SunCivil, 822261391, 822296982},
+	{9517, SUN_POSITION(60), SUN_POSITION(-122.5), SunRiseSet, 822329296, 822354983},
+	{9517, SUN_POSITION(60), SUN_POSITION(-122.5), SunCivil, 822326247, 822358031},
+	{9517, SUN_POSITION(60), SUN_POSITION(10.0), SunRiseSet, 822297537, 822323128},
+	{9517, SUN_POSITION(60), SUN_POSITION(10.0), SunCivil, 822294481, 822326185},
+	{9517, SUN_POSITION(60), SUN_POSITION(139.75), SunRiseSet, 822266437, 822291936},
+	{9517, SUN_POSITION(60), SUN_POSITION(139.75), SunCivil, 822263374, 822294999},
+	{9576, SUN_POSITION(-60), SUN_POSITION(-122.5), SunRiseSet, 827417626, 827461368},
+	{9576, SUN_POSITION(-60), SUN_POSITION(-122.5), SunCivil, 827415132, 827463862},
+	{9576, SUN_POSITION(-60), SUN_POSITION(10.0), SunRiseSet, 827385772, 827429636},
+	{9576, SUN_POSITION(-60), SUN_POSITION(10.0), SunCivil, 827383278, 827432131},
+	{9576, SUN_POSITION(-60), SUN_POSITION(139.75), SunRiseSet, 827354580, 827398562},
+	{9576, SUN_POSITION(-60), SUN_POSITION(139.75), SunCivil, 827352084, 827401058},
+	{9576, SUN_POSITION(-45), SUN_POSITION(-122.5), SunRiseSet, 827417689, 827461306},
+	{9576, SUN_POSITION(-45), SUN_POSITION(-122.5), SunCivil, 827415932, 827463062},
+	{9576, SUN_POSITION(-45), SUN_POSITION(10.0), SunRiseSet, 827385861, 827429547},
+	{9576, SUN_POSITION(-45), SUN_POSITION(10.0), SunCivil, 827384104, 827431305},
+	{9576, SUN_POSITION(-45), SUN_POSITION(139.75), SunRiseSet, 827354693, 827398448},
+	{9576, SUN_POSITION(-45), SUN_POSITION(139.75), SunCivil, 827352936, 827400206},
+	{9576, SUN_POSITION(-30), SUN_POSITION(-122.5), SunRiseSet, 827417709, 827461285},
+	{9576, SUN_POSITION(-30), SUN_POSITION(-122.5), SunCivil, 827416277, 827462718},
+	{9576, SUN_POSITION(-30), SUN_POSITION(10.0), SunRiseSet, 827385896, 827429512},
+	{9576, SUN_POSITION(-30), SUN_POSITION(10.0), SunCivil, 827384463, 827430945},
+	{9576, SUN_POSITION(-30), SUN_POSITION(139.75), SunRiseSet, 827354743, 827398399},
+	{9576, SUN_POSITION(-30), SUN_POSITION(139.75), SunCivil, 827353310, 827399832},
+	{9576, SUN_POSITION(-15), SUN_POSITION(-122.5), SunRiseSet, 827417710, 827461284},
+	{9576, SUN_POSITION(-15), SUN_POSITION(-122.5), SunCivil, 827416426, 827462568},
+	{9576, SUN_POSITION(-15), SUN_POSITION(10.0), SunRiseSet, 827385908, 827429501},
+	{9576, SUN_POSITION(-15), SUN_POSITION(10.0), SunCivil, 827384624, 827430784},
+	{9576, SUN_POSITION(-15), SUN_POSITION(139.75), SunRiseSet, 827354765, 827398376},
+	{9576, SUN_POSITION(-15), SUN_POSITION(139.75), SunCivil, 827353481, 827399660},
+	{9576, SUN_POSITION(0), SUN_POSITION(-122.5), SunRiseSet, 827417697, 827461297},
+	{9576, SUN_POSITION(0), SUN_POSITION(-122.5), SunCivil, 827416457, 827462537},
+	{9576, SUN_POSITION(0), SUN_POSITION(10.0), SunRiseSet, 827385904, 827429504},
+	{9576, SUN_POSITION(0), SUN_POSITION(10.0), SunCivil, 827384664, 827430744},
+	{9576, SUN_POSITION(0), SUN_POSITION(139.75), SunRiseSet, 827354771, 827398371},
+	{9576, SUN_POSITION(0), SUN_POSITION(139.75), SunCivil, 827353531, 827399611},
+	{9576, SUN_POSITION(15), SUN_POSITION(-122.5), SunRiseSet, 827417670, 827461324},
+	{9576, SUN_POSITION(15), SUN_POSITION(-122.5), SunCivil, 827416386, 827462608},
+	{9576, SUN_POSITION(15), SUN_POSITION(10.0), SunRiseSet, 827385887, 827429522},
+	{9576, SUN_POSITION(15), SUN_POSITION(10.0), SunCivil, 827384602, 827430806},
+	{9576, SUN_POSITION(15), SUN_POSITION(139.75), SunRiseSet, 827354762, 827398379},
+	{9576, SUN_POSITION(15), SUN_POSITION(139.75), SunCivil, 827353478, 827399663},
+	{9576, SUN_POSITION(30), SUN_POSITION(-122.5), SunRiseSet, 827417623, 827461371},
+	{9576, SUN_POSITION(30), SUN_POSITION(-122.5), SunCivil, 827416190, 827462804},
+	{9576, SUN_POSITION(30), SUN_POSITION(10.0), SunRiseSet, 827385851, 827429558},
+	{9576, SUN_POSITION(30), SUN_POSITION(10.0), SunCivil, 827384417, 827430991},
+	{9576, SUN_POSITION(30), SUN_POSITION(139.75), SunRiseSet, 827354737, 827398405},
+	{9576, SUN_POSITION(30), SUN_POSITION(139.75), SunCivil, 827353304, 827399838},
+	{9576, SUN_POSITION(45), SUN_POSITION(-122.5), SunRiseSet, 827417540, 827461454},
+	{9576, SUN_POSITION(45), SUN_POSITION(-122.5), SunCivil, 827415782, 827463213},
+	{9576, SUN_POSITION(45), SUN_POSITION(10.0), SunRiseSet, 827385782, 827429626},
+	{9576, SUN_POSITION(45), SUN_POSITION(10.0), SunCivil, 827384024, 827431384},
+	{9576, SUN_POSITION(45), SUN_POSITION(139.75), SunRiseSet, 827354683, 827398459},
+	{9576, SUN_POSITION(45), SUN_POSITION(139.75), SunCivil, 827352925, 827400216},
+	{9576, SUN_POSITION(51), SUN_POSITION(-122.5), SunRiseSet, 827417488, 827461507},
+	{9576, SUN_POSITION(51), SUN_POSITION(-122.5), SunCivil, 827415510, 827463485},
+	{9576, SUN_POSITION(51), SUN_POSITION(10.0), SunRiseSet, 827385738, 827429670},
+	{9576, SUN_POSITION(51), SUN_POSITION(10.0), SunCivil, 827383760, 827431648},
+	{9576, SUN_POSITION(51), SUN_POSITION(139.75), SunRiseSet, 827354647, 827398495},
+	{9576, SUN_POSITION(51), SUN_POSITION(139.75), SunCivil, 827352670, 827400472},
+	{9576, SUN_POSITION(60), SUN_POSITION(-122.5), SunRiseSet, 827417369, 827461626},
+	{9576, SUN_POSITION(60), SUN_POSITION(-122.5), SunCivil, 827414869, 827464125},
+	{9576, SUN_POSITION(60), SUN_POSITION(10.0), SunRiseSet, 827385636, 827429772},
+	{9576, SUN_POSITION(60), SUN_POSITION(10.0), SunCivil, 827383138, 827432270},
+	{9576, SUN_POSITION(60), SUN_POSITION(139.75), SunRiseSet, 827354562, 827398580},
+	{9576, SUN_POSITION(60), SUN_POSITION(139.75), SunCivil, 827352066, 827401076},
+	{9637, SUN_POSITION(-60), SUN_POSITION(-122.5), SunRiseSet, 832696644, 832721903},
+	{9637, SUN_POSITION(-60), SUN_POSITION(-122.5), SunCivil, 832693562, 832724986},
+	{9637, SUN_POSITION(-60), SUN_POSITION(10.0), SunRiseSet, 832664799, 832690146},
+	{9637, SUN_POSITION(-60), SUN_POSITION(10.0), SunCivil, 832661724, 832693221},
+	{9637, SUN_POSITION(-60), SUN_POSITION(139.75), SunRiseSet, 832633614, 832659048},
+	{9637, SUN_POSITION(-60), SUN_POSITION(139.75), SunCivil, 832630546, 832662116},
+	{9637, SUN_POSITION(-45), SUN_POSITION(-122.5), SunRiseSet, 832692539, 832726009},
+	{9637, SUN_POSITION(-45), SUN_POSITION(-122.5), SunCivil, 832690595, 832727953},
+	{9637, SUN_POSITION(-45), SUN_POSITION(10.0), SunRiseSet, 832660716, 832694229},
+	{9637, SUN_POSITION(-45), SUN_POSITION(10.0), SunCivil, 832658774, 832696171},
+	{9637, SUN_POSITION(-45), SUN_POSITION(139.75), SunRiseSet, 832629553, 832663108},
+	{9637, SUN_POSITION(-45), SUN_POSITION(139.75), SunCivil, 832627613, 832665049},
+	{9637, SUN_POSITION(-30), SUN_POSITION(-122.5), SunRiseSet, 832690370, 832728178},
+	{9637, SUN_POSITION(-30), SUN_POSITION(-122.5), SunCivil, 832688831, 832729717},
+	{9637, SUN_POSITION(-30), SUN_POSITION(10.0), SunRiseSet, 832658556, 832696388},
+	{9637, SUN_POSITION(-30), SUN_POSITION(10.0), SunCivil, 832657019, 832697926},
+	{9637, SUN_POSITION(-30), SUN_POSITION(139.75), SunRiseSet, 832627403, 832665259},
+	{9637, SUN_POSITION(-30), SUN_POSITION(139.75), SunCivil, 832625866, 832666795},
+	{9637, SUN_POSITION(-15), SUN_POSITION(-122.5), SunRiseSet, 832688812, 832729736},
+	{9637, SUN_POSITION(-15), SUN_POSITION(-122.5), SunCivil, 832687445, 832731103},
+	{9637, SUN_POSITION(-15), SUN_POSITION(10.0), SunRiseSet, 832657005, 832697940},
+	{9637, SUN_POSITION(-15), SUN_POSITION(10.0), SunCivil, 832655639, 832699306},
+	{9637, SUN_POSITION(-15), SUN_POSITION(139.75), SunRiseSet, 832625858, 832666803},
+	{9637, SUN_POSITION(-15), SUN_POSITION(139.75), SunCivil, 832624493, 832668169},
+	{9637, SUN_POSITION(0), SUN_POSITION(-122.5), SunRiseSet, 832687461, 832731087},
+	{9637, SUN_POSITION(0), SUN_POSITION(-122.5), SunCivil, 832686139, 832732409},
+	{9637, SUN_POSITION(0), SUN_POSITION(10.0), SunRiseSet, 832655659, 832699285},
+	{9637, SUN_POSITION(0), SUN_POSITION(10.0), SunCivil, 832654338, 832700607},
+	{9637, SUN_POSITION(0), SUN_POSITION(139.75), SunRiseSet, 832624518, 832668144},
+	{9637, SUN_POSITION(0), SUN_POSITION(139.75), SunCivil, 832623197, 832669464},
+	{9637, SUN_POSITION(15), SUN_POSITION(-122.5), SunRiseSet, 832686093, 832732455},
+	{9637, SUN_POSITION(15), SUN_POSITION(-122.5), SunCivil, 832684708, 832733840},
+	{9637, SUN_POSITION(15), SUN_POSITION(10.0), SunRiseSet, 832654297, 832700648},
+	{9637, SUN_POSITION(15), SUN_POSITION(10.0), SunCivil, 832652913, 832702032},
+	{9637, SUN_POSITION(15), SUN_POSITION(139.75), SunRiseSet, 832623161, 832669501},
+	{9637, SUN_POSITION(15), SUN_POSITION(139.75), SunCivil, 832621777, 832670884},
+	{9637, SUN_POSITION(30), SUN_POSITION(-122.5), SunRiseSet, 832684475, 832734073},
+	{9637, SUN_POSITION(30), SUN_POSITION(-122.5), SunCivil, 832682884, 832735664},
+	{9637, SUN_POSITION(30), SUN_POSITION(10.0), SunRiseSet, 832652685, 832702259},
+	{9637, SUN_POSITION(30), SUN_POSITION(10.0), SunCivil, 832651096, 832703849},
+	{9637, SUN_POSITION(30), SUN_POSITION(139.75), SunRiseSet, 832621556, 832671106},
+	{9637, SUN_POSITION(30), SUN_POSITION(139.75), SunCivil, 832619968, 832672694},
+	{9637, SUN_POSITION(45), SUN_POSITION(-122.5), SunRiseSet, 832682161, 832736387},
+	{9637, SUN_POSITION(45), SUN_POSITION(-122.5), SunCivil, 832680059, 832738489},
+	{9637, SUN_POSITION(45), SUN_POSITION(10.0), SunRiseSet, 832650381, 832704563},
+	{9637, SUN_POSITION(45), SUN_POSITION(10.0), SunCivil, 832648282, 832706662},
+	{9637, SUN_POSITION(45), SUN_POSITION(139.75), SunRiseSet, 832619262, 832673400},
+	{9637, SUN_POSITION(45), SUN_POSITION(139.75), SunCivil, 832617166, 832675496},
+	{9637, SUN_POSITION(51), SUN_POSITION(-122.5), SunRiseSet, 832680797, 832737751},
+	{9637, SUN_POSITION(51), SUN_POSITION(-122.5), SunCivil, 832678268, 832740280},
+	{9637, SUN_POSITION(51), SUN_POSITION(10.0), SunRiseSet, 832649024, 832705921},
+	{9637, SUN_POSITION(51), SUN_POSITION(10.0), SunCivil, 832646500, 832708444},
+	{9637, SUN_POSITION(51), SUN_POSITION(139.75), SunRiseSet, 832617911, 832674751},
+	{9637, SUN_POSITION(51), SUN_POSITION(139.75), SunCivil, 832615392, 832677269},
+	{9637, SUN_POSITION(60), SUN_POSITION(-122.5), SunRiseSet, 832677596, 832740952},
+	{9637, SUN_POSITION(60), SUN_POSITION(-122.5), SunCivil, 832673416, 832745132},
+	{9637, SUN_POSITION(60), SUN_POSITION(10.0), SunRiseSet, 832645842, 832709103},
+	{9637, SUN_POSITION(60), SUN_POSITION(10.0), SunCivil, 832641686, 832713259},
+	{9637, SUN_POSITION(60), SUN_POSITION(139.75), SunRiseSet, 832614747, 832677914},
+	{9637, SUN_POSITION(60), SUN_POSITION(139.75), SunCivil, 832610614, 832682047},
+	{9698, SUN_POSITION(-60), SUN_POSITION(-122.5), SunRiseSet, 837967739, 837992746},
+	{9698, SUN_POSITION(-60), SUN_POSITION(-122.5), SunCivil, 837964637, 837995848},
+	{9698, SUN_POSITION(-60), SUN_POSITION(10.0), SunRiseSet, 837935981, 837960902},
+	{9698, SUN_POSITION(-60), SUN_POSITION(10.0), SunCivil, 837932872, 837964011},
+	{9698, SUN_POSITION(-60), SUN_POSITION(139.75), SunRiseSet, 837904881, 837929720},
+	{9698, SUN_POSITION(-60), SUN_POSITION(139.75), SunCivil, 837901765, 837932836},
+	{9698, SUN_POSITION(-45), SUN_POSITION(-122.5), SunRiseSet, 837963569, 837996916},
+	{9698, SUN_POSITION(-45), SUN_POSITION(-122.5), SunCivil, 837961620, 837998865},
+	{9698, SUN_POSITION(-45), SUN_POSITION(10.0), SunRiseSet, 837931789, 837965094},
+	{9698, SUN_POSITION(-45), SUN_POSITION(10.0), SunCivil, 837929838, 837967045},
+	{9698, SUN_POSITION(-45), SUN_POSITION(139.75), SunRiseSet, 837900667, 837933933},
+	{9698, SUN_POSITION(-45), SUN_POSITION(139.75), SunCivil, 837898715, 837935886},
+	{9698, SUN_POSITION(-30), SUN_POSITION(-122.5), SunRiseSet, 837961372, 837999113},
+	{9698, SUN_POSITION(-30), SUN_POSITION(-122.5), SunCivil, 837959831, 838000654},
+	{9698, SUN_POSITION(-30), SUN_POSITION(10.0), SunRiseSet, 837929582, 837967301},
+	{9698, SUN_POSITION(-30), SUN_POSITION(10.0), SunCivil, 837928040, 837968843},
+	{9698, SUN_POSITION(-30), SUN_POSITION(139.75), SunRiseSet, 837898452, 837936148},
+	{9698, SUN_POSITION(-30), SUN_POSITION(139.75), SunCivil, 837896909, 837937691},
+	{9698, SUN_POSITION(-15), SUN_POSITION(-122.5), SunRiseSet, 837959796, 838000689},
+	{9698, SUN_POSITION(-15), SUN_POSITION(-122.5), SunCivil, 837958428, 838002058},
+	{9698, SUN_POSITION(-15), SUN_POSITION(10.0), SunRiseSet, 837928000, 837968883},
+	{9698, SUN_POSITION(-15), SUN_POSITION(10.0), SunCivil, 837926631, 837970252},
+	{9698, SUN_POSITION(-15), SUN_POSITION(139.75), SunRiseSet, 837896864, 837937737},
+	{9698, SUN_POSITION(-15), SUN_POSITION(139.75), SunCivil, 837895494, 837939107},
+	{9698, SUN_POSITION(0), SUN_POSITION(-122.5), SunRiseSet, 837958429, 838002056},
+	{9698, SUN_POSITION(0), SUN_POSITION(-122.5), SunCivil, 837957106, 838003380},
+	{9698, SUN_POSITION(0), SUN_POSITION(10.0), SunRiseSet, 837926628, 837970255},
+	{9698, SUN_POSITION(0), SUN_POSITION(10.0), SunCivil, 837925304, 837971579},
+	{9698, SUN_POSITION(0), SUN_POSITION(139.75), SunRiseSet, 837895487, 837939114},
+	{9698, SUN_POSITION(0), SUN_POSITION(139.75), SunCivil, 837894162, 837940439},
+	{9698, SUN_POSITION(15), SUN_POSITION(-122.5), SunRiseSet, 837957045, 838003440},
+	{9698, SUN_POSITION(15), SUN_POSITION(-122.5), SunCivil, 837955658, 838004827},
+	{9698, SUN_POSITION(15), SUN_POSITION(10.0), SunRiseSet, 837925239, 837971644},
+	{9698, SUN_POSITION(15), SUN_POSITION(10.0), SunCivil, 837923851, 837973032},
+	{9698, SUN_POSITION(15), SUN_POSITION(139.75), SunRiseSet, 837894092, 837940508},
+	{9698, SUN_POSITION(15), SUN_POSITION(139.75), SunCivil, 837892704, 837941896},
+	{9698, SUN_POSITION(30), SUN_POSITION(-122.5), SunRiseSet, 837955409, 838005077},
+	{9698, SUN_POSITION(30), SUN_POSITION(-122.5), SunCivil, 837953815, 838006671},
+	{9698, SUN_POSITION(30), SUN_POSITION(10.0), SunRiseSet, 837923596, 837973287},
+	{9698, SUN_POSITION(30), SUN_POSITION(10.0), SunCivil, 837922001, 837974882},
+	{9698, SUN_POSITION(30), SUN_POSITION(139.75), SunRiseSet, 837892443, 837942157},
+	{9698, SUN_POSITION(30), SUN_POSITION(139.75), SunCivil, 837890847, 837943753},
+	{9698, SUN_POSITION(45), SUN_POSITION(-122.5), SunRiseSet, 837953066, 838007420},
+	{9698, SUN_POSITION(45), SUN_POSITION(-122.5), SunCivil, 837950956, 838009530},
+	{9698, SUN_POSITION(45), SUN_POSITION(10.0), SunRiseSet, 837921243, 837975640},
+	{9698, SUN_POSITION(45), SUN_POSITION(10.0), SunCivil, 837919130, 837977753},
+	{9698, SUN_POSITION(45), SUN_POSITION(139.75), SunRiseSet, 837890081, 837944519},
+	{9698, SUN_POSITION(45), SUN_POSITION(139.75), SunCivil, 837887966, 837946635},
+	{9698, SUN_POSITION(51), SUN_POSITION(-122.5), SunRiseSet, 837951683, 838008802},
+	{9698, SUN_POSITION(51), SUN_POSITION(-122.5), SunCivil, 837949140, 838011346},
+	{9698, SUN_POSITION(51), SUN_POSITION(10.0), SunRiseSet, 837919854, 837977029},
+	{9698, SUN_POSITION(51), SUN_POSITION(10.0), SunCivil, 837917306, 837979577},
+	{9698, SUN_POSITION(51), SUN_POSITION(139.75), SunRiseSet, 837888686, 837945914},
+	{9698, SUN_POSITION(51), SUN_POSITION(139.75), SunCivil, 837886133, 837948468},
+	{9698, SUN_POSITION(60), SUN_POSITION(-122.5), SunRiseSet, 837948428, 838012058},
+	{9698, SUN_POSITION(60), SUN_POSITION(-122.5), SunCivil, 837944176, 838016310},
+	{9698, SUN_POSITION(60), SUN_POSITION(10.0), SunRiseSet, 837916581, 837980302},
+	{9698, SUN_POSITION(60), SUN_POSITION(10.0), SunCivil, 837912303, 837984580},
+	{9698, SUN_POSITION(60), SUN_POSITION(139.75), SunRiseSet, 837885395, 837949206},
+	{9698, SUN_POSITION(60), SUN_POSITION(139.75), SunCivil, 837881093, 837953508},
+	{9760, SUN_POSITION(-60), SUN_POSITION(-122.5), SunRiseSet, 843314520, 843357991},
+	{9760, SUN_POSITION(-60), SUN_POSITION(-122.5), SunCivil, 843312029, 843360482},
+	{9760, SUN_POSITION(-60), SUN_POSITION(10.0), SunRiseSet, 843282788, 843326140},
+	{9760, SUN_POSITION(-60), SUN_POSITION(10.0), SunCivil, 843280298, 843328630},
+	{9760, SUN_POSITION(-60), SUN_POSITION(139.75), SunRiseSet, 843251714, 843294950},
+	{9760, SUN_POSITION(-60), SUN_POSITION(139.75), SunCivil, 843249225, 843297439},
+	{9760, SUN_POSITION(-45), SUN_POSITION(-122.5), SunRiseSet, 843314525, 843357986},
+	{9760, SUN_POSITION(-45), SUN_POSITION(-122.5), SunCivil, 843312769, 843359742},
+	{9760, SUN_POSITION(-45), SUN_POSITION(10.0), SunRiseSet, 843282768, 843326160},
+	{9760, SUN_POSITION(-45), SUN_POSITION(10.0), SunCivil, 843281012, 843327915},
+	{9760, SUN_POSITION(-45), SUN_POSITION(139.75), SunRiseSet, 843251669, 843294994},
+	{9760, SUN_POSITION(-45), SUN_POSITION(139.75), SunCivil, 843249914, 843296749},
+	{9760, SUN_POSITION(-30), SUN_POSITION(-122.5), SunRiseSet, 843314513, 843357998},
+	{9760, SUN_POSITION(-30), SUN_POSITION(-122.5), SunCivil, 843313080, 843359431},
+	{9760, SUN_POSITION(-30), SUN_POSITION(10.0), SunRiseSet, 843282741, 843326187},
+	{9760, SUN_POSITION(-30), SUN_POSITION(10.0), SunCivil, 843281308, 843327619},
+	{9760, SUN_POSITION(-30), SUN_POSITION(139.75), SunRiseSet, 843251628, 843295035},
+	{9760, SUN_POSITION(-30), SUN_POSITION(139.75), SunCivil, 843250196, 843296467},
+	{9760, SUN_POSITION(-15), SUN_POSITION(-122.5), SunRiseSet, 843314489, 843358022},
+	{9760, SUN_POSITION(-15), SUN_POSITION(-122.5), SunCivil, 843313206, 843359306},
+	{9760, SUN_POSITION(-15), SUN_POSITION(10.0), SunRiseSet, 843282707, 843326221},
+	{9760, SUN_POSITION(-15), SUN_POSITION(10.0), SunCivil, 843281423, 843327504},
+	{9760, SUN_POSITION(-15), SUN_POSITION(139.75), SunRiseSet, 843251584, 843295080},
+	{9760, SUN_POSITION(-15), SUN_POSITION(139.75), SunCivil, 843250300, 843296363},
+	{9760, SUN_POSITION(0), SUN_POSITION(-122.5), SunRiseSet, 843314456, 843358056},
+	{9760, SUN_POSITION(0), SUN_POSITION(-122.5), SunCivil, 843313216, 843359296},
+	{9760, SUN_POSITION(0), SUN_POSITION(10.0), SunRiseSet, 843282664, 843326264},
+	{9760, SUN_POSITION(0), SUN_POSITION(10.0), SunCivil, 843281424, 843327504},
+	{9760, SUN_POSITION(0), SUN_POSITION(139.75), SunRiseSet, 843251532, 843295132},
+	{9760, SUN_POSITION(0), SUN_POSITION(139.75), SunCivil, 843250291, 843296372},
+	{9760, SUN_POSITION(15), SUN_POSITION(-122.5), SunRiseSet, 843314408, 843358103},
+	{9760, SUN_POSITION(15), SUN_POSITION(-122.5), SunCivil, 843313123, 843359388},
+	{9760, SUN_POSITION(15), SUN_POSITION(10.0), SunRiseSet, 843282607, 843326321},
+	{9760, SUN_POSITION(15), SUN_POSITION(10.0), SunCivil, 843281322, 843327605},
+	{9760, SUN_POSITION(15), SUN_POSITION(139.75), SunRiseSet, 843251466, 843295198},
+	{9760, SUN_POSITION(15), SUN_POSITION(139.75), SunCivil, 843250181, 843296482},
+	{9760, SUN_POSITION(30), SUN_POSITION(-122.5), SunRiseSet, 843314337, 843358175},
+	{9760, SUN_POSITION(30), SUN_POSITION(-122.5), SunCivil, 843312903, 843359608},
+	{9760, SUN_POSITION(30), SUN_POSITION(10.0), SunRiseSet, 843282525, 843326403},
+	{9760, SUN_POSITION(30), SUN_POSITION(10.0), SunCivil, 843281091, 843327836},
+	{9760, SUN_POSITION(30), SUN_POSITION(139.75), SunRiseSet, 843251373, 843295290},
+	{9760, SUN_POSITION(30), SUN_POSITION(139.75), SunCivil, 843249939, 843296724},
+	{9760, SUN_POSITION(45), SUN_POSITION(-122.5), SunRiseSet, 843314220, 843358291},
+	{9760, SUN_POSITION(45), SUN_POSITION(-122.5), SunCivil, 843312461, 843360050},
+	{9760, SUN_POSITION(45), SUN_POSITION(10.0), SunRiseSet, 843282394, 843326533},
+	{9760, SUN_POSITION(45), SUN_POSITION(10.0), SunCivil, 843280634, 843328293},
+	{9760, SUN_POSITION(45), SUN_POSITION(139.75), SunRiseSet, 843251228, 843295435},
+	{9760, SUN_POSITION(45), SUN_POSITION(139.75), SunCivil, 843249468, 843297195},
+	{9760, SUN_POSITION(51), SUN_POSITION(-122.5), SunRiseSet, 843314149, 843358362},
+	{9760, SUN_POSITION(51), SUN_POSITION(-122.5), SunCivil, 843312170, 843360342},
+	{9760, SUN_POSITION(51), SUN_POSITION(10.0), SunRiseSet, 843282315, 843326612},
+	{9760, SUN_POSITION(51), SUN_POSITION(10.0), SunCivil, 843280334, 843328593},
+	{9760, SUN_POSITION(51), SUN_POSITION(139.75), SunRiseSet, 843251141, 843295522},
+	{9760, SUN_POSITION(51), SUN_POSITION(139.75), SunCivil, 843249160, 843297503},
+	{9760, SUN_POSITION(60), SUN_POSITION(-122.5), SunRiseSet, 843313991, 843358520},
+	{9760, SUN_POSITION(60), SUN_POSITION(-122.5), SunCivil, 843311489, 843361023},
+	{9760, SUN_POSITION(60), SUN_POSITION(10.0), SunRiseSet, 843282140, 843326788},
+	{9760, SUN_POSITION(60), SUN_POSITION(10.0), SunCivil, 843279635, 843329292},
+	{9760, SUN_POSITION(60), SUN_POSITION(139.75), SunRiseSet, 843250949, 843295714},
+	{9760, SUN_POSITION(60), SUN_POSITION(139.75), SunCivil, 843248443, 843298220},
+	{9821, SUN_POSITION(-60), SUN_POSITION(-122.5), SunRiseSet, 848574728, 848637739},
+	{9821, SUN_POSITION(-60), SUN_POSITION(-122.5), SunCivil, 848570633, 848641834},
+	{9821, SUN_POSITION(-60), SUN_POSITION(10.0), SunRiseSet, 848542973, 848605883},
+	{9821, SUN_POSITION(-60), SUN_POSITION(10.0), SunCivil, 848538903, 848609953},
+	{9821, SUN_POSITION(-60), SUN_POSITION(139.75), SunRiseSet, 848511878, 848574687},
+	{9821, SUN_POSITION(-60), SUN_POSITION(139.75), SunCivil, 848507832, 848578733},
+	{9821, SUN_POSITION(-45), SUN_POSITION(-122.5), SunRiseSet, 848579201, 848633266},
+	{9821, SUN_POSITION(-45), SUN_POSITION(-122.5), SunCivil, 848577110, 848635358},
+	{9821, SUN_POSITION(-45), SUN_POSITION(10.0), SunRiseSet, 848547420, 848601436},
+	{9821, SUN_POSITION(-45), SUN_POSITION(10.0), SunCivil, 848545331, 848603525},
+	{9821, SUN_POSITION(-45), SUN_POSITION(139.75), SunRiseSet, 848516298, 848570267},
+	{9821, SUN_POSITION(-45), SUN_POSITION(139.75), SunCivil, 848514212, 848572352},
+	{9821, SUN_POSITION(-30), SUN_POSITION(-122.5), SunRiseSet, 848581479, 848630989},
+	{9821, SUN_POSITION(-30), SUN_POSITION(-122.5), SunCivil, 848579893, 848632575},
+	{9821, SUN_POSITION(-30), SUN_POSITION(10.0), SunRiseSet, 848549686, 848599170},
+	{9821, SUN_POSITION(-30), SUN_POSITION(10.0), SunCivil, 848548102, 848600754},
+	{9821, SUN_POSITION(-30), SUN_POSITION(139.75), SunRiseSet, 848518554, 848568011},
+	{9821, SUN_POSITION(-30), SUN_POSITION(139.75), SunCivil, 848516970, 848569595},
+	{9821, SUN_POSITION(-15), SUN_POSITION(-122.5), SunRiseSet, 848583073, 848629395},
+	{9821, SUN_POSITION(-15), SUN_POSITION(-122.5), SunCivil, 848581691, 848630777},
+	{9821, SUN_POSITION(-15), SUN_POSITION(10.0), SunRiseSet, 848551273, 848597583},
+	{9821, SUN_POSITION(-15), SUN_POSITION(10.0), SunCivil, 848549892, 848598964},
+	{9821, SUN_POSITION(-15), SUN_POSITION(139.75), SunRiseSet, 848520134, 848566431},
+	{9821, SUN_POSITION(-15), SUN_POSITION(139.75), SunCivil, 848518753, 848567812},
+	{9821, SUN_POSITION(0), SUN_POSITION(-122.5), SunRiseSet, 848584421, 848628046},
+	{9821, SUN_POSITION(0), SUN_POSITION(-122.5), SunCivil, 848583101, 848629366},
+	{9821, SUN_POSITION(0), SUN_POSITION(10.0), SunRiseSet, 848552615, 848596241},
+	{9821, SUN_POSITION(0), SUN_POSITION(10.0), SunCivil, 848551296, 848597560},
+	{9821, SUN_POSITION(0), SUN_POSITION(139.75), SunRiseSet, 848521470, 848565095},
+	{9821, SUN_POSITION(0), SUN_POSITION(139.75), SunCivil, 848520152, 848566413},
+	{9821, SUN_POSITION(15), SUN_POSITION(-122.5), SunRiseSet, 848585752, 848626715},
+	{9821, SUN_POSITION(15), SUN_POSITION(-122.5), SunCivil, 848584388, 848628079},
+	{9821, SUN_POSITION(15), SUN_POSITION(10.0), SunRiseSet, 848553941, 848594915},
+	{9821, SUN_POSITION(15), SUN_POSITION(10.0), SunCivil, 848552577, 848596279},
+	{9821, SUN_POSITION(15), SUN_POSITION(139.75), SunRiseSet, 848522789, 848563776},
+	{9821, SUN_POSITION(15), SUN_POSITION(139.75), SunCivil, 848521427, 848565138},
+	{9821, SUN_POSITION(30), SUN_POSITION(-122.5), SunRiseSet, 848587286, 848625181},
+	{9821, SUN_POSITION(30), SUN_POSITION(-122.5), SunCivil, 848585751, 848626716},
+	{9821, SUN_POSITION(30), SUN_POSITION(10.0), SunRiseSet, 848555468, 848593388},
+	{9821, SUN_POSITION(30), SUN_POSITION(10.0), SunCivil, 848553934, 848594922},
+	{9821, SUN_POSITION(30), SUN_POSITION(139.75), SunRiseSet, 848524310, 848562255},
+	{9821, SUN_POSITION(30), SUN_POSITION(139.75), SunCivil, 848522776, 848563789},
+	{9821, SUN_POSITION(45), SUN_POSITION(-122.5), SunRiseSet, 848589421, 848623047},
+	{9821, SUN_POSITION(45), SUN_POSITION(-122.5), SunCivil, 848587483, 848624984},
+	{9821, SUN_POSITION(45), SUN_POSITION(10.0), SunRiseSet, 848557592, 848591264},
+	{9821, SUN_POSITION(45), SUN_POSITION(10.0), SunCivil, 848555656, 848593200},
+	{9821, SUN_POSITION(45), SUN_POSITION(139.75), SunRiseSet, 848526423, 848560142},
+	{9821, SUN_POSITION(45), SUN_POSITION(139.75), SunCivil, 848524489, 848562076},
+	{9821, SUN_POSITION(51), SUN_POSITION(-122.5), SunRiseSet, 848590650, 848621818},
+	{9821, SUN_POSITION(51), SUN_POSITION(-122.5), SunCivil, 848588415, 848624052},
+	{9821, SUN_POSITION(51), SUN_POSITION(10.0), SunRiseSet, 848558814, 848590042},
+	{9821, SUN_POSITION(51), SUN_POSITION(10.0), SunCivil, 848556583, 848592273},
+	{9821, SUN_POSITION(51), SUN_POSITION(139.75), SunRiseSet, 848527639, 848558926},
+	{9821, SUN_POSITION(51), SUN_POSITION(139.75), SunCivil, 848525410, 848561154},
+	{9821, SUN_POSITION(60), SUN_POSITION(-122.5), SunRiseSet, 848593445, 848619023},
+	{9821, SUN_POSITION(60), SUN_POSITION(-122.5), SunCivil, 848590387, 848622080},
+	{9821, SUN_POSITION(60), SUN_POSITION(10.0), SunRiseSet, 848561591, 848587264},
+	{9821, SUN_POSITION(60), SUN_POSITION(10.0), SunCivil, 848558542, 848590314},
+	{9821, SUN_POSITION(60), SUN_POSITION(139.75), SunRiseSet, 848530399, 848556166},
+	{9821, SUN_POSITION(60), SUN_POSITION(139.75), SunCivil, 848527357, 848559208},
+	{18069, SUN_POSITION(-60), SUN_POSITION(-122.5), SunRiseSet, 1561223814, 1561244937},
+	{18069, SUN_POSITION(-60), SUN_POSITION(-122.5), SunCivil, 1561220345, 1561248406},
+	{18069, SUN_POSITION(-60), SUN_POSITION(10.0), SunRiseSet, 1561192009, 1561213133},
+	{18069, SUN_POSITION(-60), SUN_POSITION(10.0), SunCivil, 1561188540, 1561216602},
+	{18069, SUN_POSITION(-60), SUN_POSITION(139.75), SunRiseSet, 1561160864, 1561181989},
+	{18069, SUN_POSITION(-60), SUN_POSITION(139.75), SunCivil, 1561157395, 1561185458},
+	{18069, SUN_POSITION(-45), SUN_POSITION(-122.5), SunRiseSet, 1561218602, 1561250149},
+	{18069, SUN_POSITION(-45), SUN_POSITION(-122.5), SunCivil, 1561216570, 1561252181},
+	{18069, SUN_POSITION(-45), SUN_POSITION(10.0), SunRiseSet, 1561186798, 1561218345},
+	{18069, SUN_POSITION(-45), SUN_POSITION(10.0), SunCivil, 1561184765, 1561220377},
+	{18069, SUN_POSITION(-45), SUN_POSITION(139.75), SunRiseSet, 1561155653, 1561187201},
+	{18069, SUN_POSITION(-45), SUN_POSITION(139.75), SunCivil, 1561153621, 1561189233},
+	{18069, SUN_POSITION(-30), SUN_POSITION(-122.5), SunRiseSet, 1561215995, 1561252756},
+	{18069, SUN_POSITION(-30), SUN_POSITION(-122.5), SunCivil, 1561214413, 1561254339},
+	{18069, SUN_POSITION(-30), SUN_POSITION(10.0), SunRiseSet, 1561184191, 1561220951},
+	{18069, SUN_POSITION(-30), SUN_POSITION(10.0), SunCivil, 1561182608, 1561222534},
+	{18069, SUN_POSITION(-30), SUN_POSITION(139.75), SunRiseSet, 1561153046, 1561189807},
+	{18069, SUN_POSITION(-30), SUN_POSITION(139.75), SunCivil, 1561151463, 1561191390},
+	{18069, SUN_POSITION(-15), SUN_POSITION(-122.5), SunRiseSet, 1561214150, 1561254601},
+	{18069, SUN_POSITION(-15), SUN_POSITION(-122.5), SunCivil, 1561212751, 1561256000},
+	{18069, SUN_POSITION(-15), SUN_POSITION(10.0), SunRiseSet, 1561182345, 1561222797},
+	{18069, SUN_POSITION(-15), SUN_POSITION(10.0), SunCivil, 1561180947, 1561224196},
+	{18069, SUN_POSITION(-15), SUN_POSITION(139.75), SunRiseSet, 1561151201, 1561191653},
+	{18069, SUN_POSITION(-15), SUN_POSITION(139.75), SunCivil, 1561149802, 1561193051},
+	{18069, SUN_POSITION(0), SUN_POSITION(-122.5), SunRiseSet, 1561212558, 1561256194},
+	{18069, SUN_POSITION(0), SUN_POSITION(-122.5), SunCivil, 1561211206, 1561257546},
+	{18069, SUN_POSITION(0), SUN_POSITION(10.0), SunRiseSet, 1561180753, 1561224389},
+	{18069, SUN_POSITION(0), SUN_POSITION(10.0), SunCivil, 1561179401, 1561225741},
+	{18069, SUN_POSITION(0), SUN_POSITION(139.75), SunRiseSet, 1561149609, 1561193245},
+	{18069, SUN_POSITION(0), SUN_POSITION(139.75), SunCivil, 1561148257, 1561194597},
+	{18069, SUN_POSITION(15), SUN_POSITION(-122.5), SunRiseSet, 1561210947, 1561257804},
+	{18069, SUN_POSITION(15), SUN_POSITION(-122.5), SunCivil, 1561209526, 1561259225},
+	{18069, SUN_POSITION(15), SUN_POSITION(10.0), SunRiseSet, 1561179143, 1561226000},
+	{18069, SUN_POSITION(15), SUN_POSITION(10.0), SunCivil, 1561177722, 1561227421},
+	{18069, SUN_POSITION(15), SUN_POSITION(139.75), SunRiseSet, 1561147998, 1561194855},
+	{18069, SUN_POSITION(15), SUN_POSITION(139.75), SunCivil, 1561146577, 1561196276},
+	{18069, SUN_POSITION(30), SUN_POSITION(-122.5), SunRiseSet, 1561209036, 1561259715},
+	{18069, SUN_POSITION(30), SUN_POSITION(-122.5), SunCivil, 1561207388, 1561261364},
+	{18069, SUN_POSITION(30), SUN_POSITION(10.0), SunRiseSet, 1561177232, 1561227911},
+	{18069, SUN_POSITION(30), SUN_POSITION(10.0), SunCivil, 1561175583, 1561229559},
+	{18069, SUN_POSITION(30), SUN_POSITION(139.75), SunRiseSet, 1561146087, 1561196766},
+	{18069, SUN_POSITION(30), SUN_POSITION(139.75), SunCivil, 1561144439, 1561198414},
+	{18069, SUN_POSITION(45), SUN_POSITION(-122.5), SunRiseSet, 1561206265, 1561262486},
+	{18069, SUN_POSITION(45), SUN_POSITION(-122.5), SunCivil, 1561204018, 1561264733},
+	{18069, SUN_POSITION(45), SUN_POSITION(10.0), SunRiseSet, 1561174461, 1561230682},
+	{18069, SUN_POSITION(45), SUN_POSITION(10.0), SunCivil, 1561172214, 1561232929},
+	{18069, SUN_POSITION(45), SUN_POSITION(139.75), SunRiseSet, 1561143317, 1561199537},
+	{18069, SUN_POSITION(45), SUN_POSITION(139.75), SunCivil, 1561141070, 1561201784},
+	{18069, SUN_POSITION(51), SUN_POSITION(-122.5), SunRiseSet, 1561204593, 1561264159},
+	{18069, SUN_POSITION(51), SUN_POSITION(-122.5), SunCivil, 1561201793, 1561266958},
+	{18069, SUN_POSITION(51), SUN_POSITION(10.0), SunRiseSet, 1561172788, 1561232354},
+	{18069, SUN_POSITION(51), SUN_POSITION(10.0), SunCivil, 1561169989, 1561235154},
+	{18069, SUN_POSITION(51), SUN_POSITION(139.75), SunRiseSet, 1561141644, 1561201209},
+	{18069, SUN_POSITION(51), SUN_POSITION(139.75), SunCivil, 1561138845, 1561204009},
+	{18069, SUN_POSITION(60), SUN_POSITION(-122.5), SunRiseSet, 1561200415, 1561268336},
+	{18069, SUN_POSITION(60), SUN_POSITION(-122.5), SunCivil, 1561194011, 1561274740},
+	{18069, SUN_POSITION(60), SUN_POSITION(10.0), SunRiseSet, 1561168611, 1561236532},
+	{18069, SUN_POSITION(60), SUN_POSITION(10.0), SunCivil, 1561162208, 1561242934},
+	{18069, SUN_POSITION(60), SUN_POSITION(139.75), SunRiseSet, 1561137467, 1561205386},
+	{18069, SUN_POSITION(60), SUN_POSITION(139.75), SunCivil, 1561131067, 1561211787},
+};
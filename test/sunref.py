@@ -0,0 +1,52 @@
+#!/usr/bin/env python3
+# Reference table for test/sun.c: the sunrise equation of sun.c in double precision,
+# with the third term of the equation of the centre which sun.c leaves out
+#
+# Usage: sunref.py > sunref.h
+
+import math
+from datetime import date
+
+TWILIGHTS = [('SunRiseSet', -0.833), ('SunCivil', -6.0)]
+LATITUDES = [-60, -45, -30, -15, 0, 15, 30, 45, 51, 60]
+LONGITUDES = [-122.5, 10.0, 139.75]
+DAYS = [(date(2026, month, 21) - date(2000, 1, 1)).days for month in range(1, 13, 2)] + [(date(2049, 6, 21) - date(2000, 1, 1)).days]
+
+def sin(degrees):
+	return math.sin(math.radians(degrees))
+
+def riseSet(day, latitude, longitude, elevation):
+	# Days since J2000.0 (2000-01-01 12:00 UTC), as in sun.c
+	noon = day + 0.0008 - longitude / 360
+	anomaly = (357.5291 + 0.98560028 * noon) % 360
+	center = 1.9148 * sin(anomaly) + 0.0200 * sin(2 * anomaly) + 0.0003 * sin(3 * anomaly)
+	eclipticLongitude = (anomaly + center + 180 + 102.9372) % 360
+	transit = noon + 0.0053 * sin(anomaly) - 0.0069 * sin(2 * eclipticLongitude)
+	sinDeclination = sin(eclipticLongitude) * sin(23.4397)
+	cosDeclination = math.sqrt(1 - sinDeclination ** 2)
+	cosHourAngle = (sin(elevation) - sin(latitude) * sinDeclination) / (math.cos(math.radians(latitude)) * cosDeclination)
+	if abs(cosHourAngle) >= 1:
+		return None
+	hourAngle = math.degrees(math.acos(cosHourAngle)) / 360
+	# UTC timestamps since 2000-01-01 00:00
+	return [round((transit + sign * hourAngle) * 86400 + 43200) for sign in (-1, 1)]
+
+def main():
+	print('// Generated by sunref.py, do not edit')
+	print('static const struct {')
+	print('\tuint16_t\tday;')
+	print('\tint16_t\t\tlatitude, longitude;\t// SUN_POSITION')
+	print('\tSunTwilight_t\ttwilight;')
+	print('\ttime_t\t\trise, set;')
+	print('} sunReference[] = {')
+	for day in DAYS:
+		for latitude in LATITUDES:
+			for longitude in LONGITUDES:
+				for name, elevation in TWILIGHTS:
+					times = riseSet(day, latitude, longitude, elevation)
+					if times:
+						print('\t{%d, SUN_POSITION(%s), SUN_POSITION(%s), %s, %d, %d},' % (day, latitude, longitude, name, times[0], times[1]))
+	print('};')
+
+if __name__ == '__main__':
+	main()
@@ -0,0 +1,111 @@
+// Main loop wakeups of clock_setAlarm: timer1 and the sleep loop of Zeitschaltuhr.c run for one hour
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <time.h>
+static void set_system_time(time_t timestamp);
+#include "../clock.c"
+
+static void set_system_time(time_t timestamp ATTR_MAYBE_UNUSED)
+{
+}
+
+static unsigned failures;
+static void check(bool ok, const char *test, unsigned run)
+{
+	if(!ok && failures++ < 10)
+		printf("FAIL %s, %u\n", test, run);
+}
+
+static uint32_t state32 = 2463534242u;
+static uint32_t random32(void)
+{
+	state32 ^= state32 << 13;
+	state32 ^= state32 >> 17;
+	state32 ^= state32 << 5;
+	return state32;
+}
+
+static unsigned tickInterrupts, alarmInterrupts;
+
+// Timer1 counts up to its next interrupt, the two ISRs of timer1.h
+static void runTimer(void)
+{
+	if((TIMSK1 & _BV(OCIE1B)) && OCR1B > TCNT1 && OCR1B <= OCR1A)
+	{
+		TCNT1 = OCR1B;
+		alarmInterrupts++;
+		TIMSK1 &= ~_BV(OCIE1B);
+		sleep_disable();
+		return;
+	}
+	// CTC clears the counter on compare A
+	TCNT1 = 0;
+	tickInterrupts++;
+	clock_tick();
+}
+
+// The sleep loop for one hour. checkRules sets an alarm at the next deadline, they are random
+// and up to maxPeriod apart, or cancels it if maxPeriod is 0. Returns the wakeups of the main loop.
+static unsigned runHour(Time_t maxPeriod)
+{
+	Time_t end = clock_getMonotonic() + TIME_SECONDS(3600);
+	Time_t deadline = clock_getMonotonic() + 1 + (maxPeriod ? random32() % maxPeriod : 0);
+	unsigned wakeups = 0, deadlines = 0;
+	for(;;)
+	{
+		sleep_enable();
+		if(maxPeriod)
+			clock_setAlarm(deadline);
+		else
+			clock_cancelAlarm();
+
+		while(SMCR & _BV(SE))
+		{
+			runTimer();
+			if(!TIME_BEFORE(clock_getMonotonic(), end))
+			{
+				check(wakeups == deadlines, "one wakeup per deadline", wakeups);
+				return wakeups;
+			}
+		}
+		wakeups++;
+
+		// Early, checkRules would find no expired timer and set the same alarm again
+		Time_t now = clock_getMonotonic();
+		check(now == deadline, "woken at the deadline", wakeups);
+		if(!TIME_BEFORE(now, deadline))
+		{
+			deadlines++;
+			deadline += 1 + random32() % maxPeriod;
+		}
+		else if(TCNT1 < OCR1A)	// The pass of the main loop takes a tick
+			TCNT1++;
+		else
+			runTimer();
+	}
+}
+
+int main(void)
+{
+	OCR1A = CLOCK_COMPARE;
+
+	unsigned idle = runHour(0);
+	unsigned ticks = tickInterrupts;
+	check(idle == 0, "no wakeup while idle", idle);
+	check(alarmInterrupts == 0, "no compare B while idle", alarmInterrupts);
+
+	unsigned sparse = runHour(TIME_SECONDS(120));
+	unsigned busy = runHour(TIME_MS(500));
+
+	// The one second interrupt still runs for the clock and the watchdog, only the main loop sleeps through it
+	printf("tickless: %u one second interrupts per hour, main loop woken %u times idle, %u with alarms up to 2 min apart, %u up to 0.5 s apart\n",
+	       ticks, idle, sparse, busy);
+	if(failures)
+	{
+		printf("tickless: %u failures\n", failures);
+		return EXIT_FAILURE;
+	}
+	printf("tickless: OK\n");
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,8 @@
+#ifndef _UTIL_ATOMIC_H_
+#define _UTIL_ATOMIC_H_
+// The host tests have no interrupts
+#define ATOMIC_RESTORESTATE
+#define ATOMIC_FORCEON
+#define ATOMIC_BLOCK(type) for(int _atomicDone = 0; !_atomicDone; _atomicDone = 1)
+
+#endif
@@ -7,13 +7,15 @@
 #include <time.h>
 #include <avr/interrupt.h>
 #include <avr/sleep.h>
+#include "clock.h"
 
 #ifdef __cplusplus
 extern "C"
 {
 #endif
 
-static inline void timer1_init(uint32_t ticks)
+// Prescaler and compare value come from F_CPU, see clock.h
+static inline void timer1_init(void)
 {
 	power_timer1_enable();
 	TCCR1B = 0;			// Timer ausschalten
@@ -21,36 +23,8 @@ static inline void timer1_init(uint32_t ticks)
 	TCNT1 = 0;			// Timer Reset
 	TIFR1 = 0xff;			// Interrupt Flags zurücksetzen
 
-	uint16_t max;
-	uint8_t  prescaler;
-
-	if(ticks <= 65536) {
-		max = (uint16_t)(ticks - 1);
-		prescaler = _BV(CS10);
-	}
-	else if (ticks <= (8*65536LL)) {
-		//staticassert(ticks % 8 == 0, "precision not supported");
-		max = (uint16_t)(ticks / 8 - 1);
-		prescaler = _BV(CS11);
-	}
-	else if (ticks <= (64*65536LL)) {
-		//staticassert(ticks % 64 == 0, "precision not supported");
-		max = (uint16_t)(ticks / 64 - 1);
-		prescaler = _BV(CS11) | _BV(CS10);
-	}
-	else if (ticks <= (256*65536LL)) {
-		//staticassert(ticks % 256 == 0, "precision not supported");
-		max = (uint16_t)(ticks / 256 - 1);
-		prescaler = _BV(CS12);
-	}
-	else if (ticks <= (1024*65536LL)) {
-		//_Static_assert(ticks % 1024 == 0, "precision not supported");
-		max = (uint16_t)(ticks / 1024 - 1);
-		prescaler = _BV(CS12) | _BV(CS10);
-	}
-	//else {
-	//	staticassert(ticks > (1024*256LL), "ticks value to large");
-	//}
+	const uint16_t max = CLOCK_COMPARE;
+	const uint8_t prescaler = CLOCK_PRESCALER_BITS;
 
 #ifdef TIMER1_USE_ICR
 	ICR1   = max;			// CTC Ende
@@ -58,11 +32,18 @@ static inline void timer1_init(uint32_t ticks)
 	TCCR1B = (_BV(WGM13) | _BV(WGM12) | prescaler;
 #else
 	OCR1A  = max;			// CTC Ende
-	TIMSK1 = (1 << OCIE1A);		// Interrupt einschalten
+	TIMSK1 = (1 << OCIE1A);		// Interrupt einschalten, OCIE1B is used by clock_setAlarm
 	TCCR1B = _BV(WGM12) | prescaler;
 #endif
 }
 
+// Alarm of clock_setAlarm, one shot
+ISR(TIMER1_COMPB_vect)
+{
+	TIMSK1 &= ~_BV(OCIE1B);
+	sleep_disable();
+}
+
 __attribute__((destructor)) static void timer1_stop(void)
 {
 	TCCR1B = 0;
@@ -76,7 +57,7 @@ ISR(TIMER1_CAPT_vect)
 ISR(TIMER1_COMPA_vect)
 #endif
 {
-	sleep_disable();
+	clock_tick();	// Wakes the main loop only if the alarm is due
 	system_tick();
 }
 
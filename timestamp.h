@@ -1,34 +1,39 @@
 #ifndef timestamp_h
 #define timestamp_h
 
-// eu_dst from avr_libc is broken, avr-libc bug #44327
-static inline int eu_dst(const time_t *timer, __attribute__((unused)) int32_t *z)
+// UTC transitions of the timezone, generated by tzgen.py from TIMEZONE in the makefile
+typedef struct {
+	time_t		utc;		// Start of this offset
+	int32_t		offset;		// Local time minus UTC in seconds, including DST
+} tz_transition_t;
+#include "tzdata.h"
+
+// Offset of the local time at the given UTC time, binary search for the last transition before it
+static int32_t tz_offset(time_t utc)
 {
-	uint32_t t = *timer;
-	if ((uint8_t)(t >> 24) >= 194) t -= 3029443200U;
-	t = (t + 655513200) / 604800 * 28;
-	if ((uint16_t)(t % 1461) < 856) return 3600;
-	else return 0;
+	uint16_t low = 0, high = ARRAY_SIZE(tz_transitions);
+	while(high - low > 1)
+	{
+		uint16_t middle = low + (high - low) / 2;
+		if(tz_transitions[middle].utc <= utc)
+			low = middle;
+		else
+			high = middle;
+	}
+	return tz_transitions[low].offset;
 }
 
-#define UTC_OFFSET (1 * ONE_HOUR)
-
 static time_t calculateTimestamp(struct tm *time, int8_t hour, int8_t min)
 {
 	time->tm_hour = hour, time->tm_min = min; // tm_sec already 0
 
-	// Following is equivalent to mktime without changing it's arguments but recalculate dst each time
-	// time->tm_isdst = -1; return mktime(time);
-
-	// Convert localtime as UTC and correct it by UTC offset
-	int32_t utcoffset = UTC_OFFSET;
-	time_t retVal = mk_gmtime(time) - utcoffset;
-
-	// Additionally correct time by DST offset (if DST rules are configured)
+	// Convert localtime as UTC and correct it by the offset, which is looked up for the
+	// time converted with the standard offset (like mktime with tm_isdst = 0 would do)
 	// Orders scheduled in the lost hour in spring are executed one hour early
 	// Orders scheduled in the repeated hour in autumn are executed only one time
 	// after the time shift
-	return retVal - eu_dst(&retVal, &utcoffset);
+	time_t localTime = mk_gmtime(time);
+	return localTime - tz_offset(localTime - TZ_STD_OFFSET);
 }
 static time_t _nextMidnight = 0;
 static struct tm *getStructTM(time_t now)
@@ -36,7 +41,8 @@ static struct tm *getStructTM(time_t now)
 	static struct tm tm = {0};
 	if(now >= _nextMidnight)
 	{
-		localtime_r(&now, &tm);
+		time_t localTime = now + tz_offset(now);
+		gmtime_r(&localTime, &tm);
 		tm.tm_sec = 0;	// ignore seconds
 
 		_nextMidnight = calculateTimestamp(&tm, 24, 0);
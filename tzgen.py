@@ -0,0 +1,108 @@
+#!/usr/bin/env python3
+# Expands a POSIX TZ string into a table of UTC transition instants for timestamp.h
+#
+# Usage: tzgen.py "CET-1CEST,M3.5.0,M10.5.0/3" [first year] [last year] > tzdata.h
+
+import re
+import sys
+from datetime import datetime, timedelta, timezone
+
+# time_t of avr-libc counts from 2000-01-01 00:00 UTC
+EPOCH = datetime(2000, 1, 1, tzinfo=timezone.utc)
+
+def parseOffset(text):
+	# [+-]hh[:mm[:ss]], returns seconds
+	match = re.fullmatch(r'([+-]?)(\d{1,3})(?::(\d{1,2}))?(?::(\d{1,2}))?', text)
+	if not match:
+		raise ValueError('invalid offset or time "%s"' % text)
+	seconds = int(match.group(2)) * 3600 + int(match.group(3) or 0) * 60 + int(match.group(4) or 0)
+	return -seconds if match.group(1) == '-' else seconds
+
+def parseName(text):
+	# Either alphabetic or quoted in <>
+	match = re.match(r'<[^>]*>|[A-Za-z]{3,}', text)
+	if not match:
+		raise ValueError('invalid zone name in "%s"' % text)
+	return text[match.end():]
+
+def splitOffset(text):
+	match = re.match(r'[+-]?\d{1,3}(?::\d{1,2}){0,2}', text)
+	if not match:
+		return None, text
+	return match.group(0), text[match.end():]
+
+def parseRule(text):
+	# Jn, n or Mm.w.d with optional /time (default 02:00)
+	date, _, time = text.partition('/')
+	return date, parseOffset(time) if time else 2 * 3600
+
+def ruleDate(date, year):
+	# Local date of the rule in the given year
+	if date.startswith('M'):
+		month, week, wday = (int(x) for x in date[1:].split('.'))
+		first = datetime(year, month, 1)
+		day = first + timedelta(days=(wday - (first.isoweekday() % 7)) % 7 + (week - 1) * 7)
+		if week == 5:
+			while day.month != month:
+				day -= timedelta(days=7)
+		return day
+	if date.startswith('J'):
+		# 1 ... 365, February 29 is never counted
+		day = datetime(year, 1, 1) + timedelta(days=int(date[1:]) - 1)
+		if year % 4 == 0 and (year % 100 != 0 or year % 400 == 0) and day.month > 2:
+			day += timedelta(days=1)
+		return day
+	return datetime(year, 1, 1) + timedelta(days=int(date))
+
+def parseTZ(text):
+	# Returns the standard offset east of UTC and a function yielding the transitions of a year
+	rest = parseName(text)
+	offset, rest = splitOffset(rest)
+	if offset is None:
+		raise ValueError('missing offset in "%s"' % text)
+	std = -parseOffset(offset)		# POSIX offsets are west of UTC
+	if not rest:
+		return std, lambda year: []
+
+	rest = parseName(rest)
+	offset, rest = splitOffset(rest)
+	dst = -parseOffset(offset) if offset else std + 3600
+	rules = rest[1:].split(',') if rest.startswith(',') else ['M3.2.0', 'M11.1.0']
+	if len(rules) != 2:
+		raise ValueError('expected two rules in "%s"' % text)
+	start, end = (parseRule(rule) for rule in rules)
+
+	def transitions(year):
+		# The start is given in standard time, the end in daylight saving time
+		startUTC = ruleDate(start[0], year) + timedelta(seconds=start[1] - std)
+		endUTC = ruleDate(end[0], year) + timedelta(seconds=end[1] - dst)
+		return [(startUTC.replace(tzinfo=timezone.utc), dst), (endUTC.replace(tzinfo=timezone.utc), std)]
+	return std, transitions
+
+def main():
+	if len(sys.argv) < 2:
+		sys.exit('usage: tzgen.py TZ [first year] [last year]')
+	tz = sys.argv[1]
+	first = int(sys.argv[2]) if len(sys.argv) > 2 else 2020
+	last = int(sys.argv[3]) if len(sys.argv) > 3 else 2050
+
+	std, transitions = parseTZ(tz)
+	allTransitions = sorted(t for year in range(first - 1, last + 1) for t in transitions(year))
+
+	# Before the first year the offset of the last transition of the previous year applies
+	start = datetime(first, 1, 1, tzinfo=timezone.utc)
+	initial = std
+	for instant, offset in allTransitions:
+		if instant < start:
+			initial = offset
+	table = [(EPOCH, initial)] + [t for t in allTransitions if t[0] >= start]
+
+	print('// Generated by tzgen.py from TIMEZONE="%s" for %d ... %d, do not edit' % (tz, first, last))
+	print('#define TZ_STD_OFFSET %dL' % std)
+	print('static const __flash tz_transition_t tz_transitions[] = {')
+	for instant, offset in table:
+		print('\t{%dUL, %d},\t// %s' % ((instant - EPOCH).total_seconds(), offset, instant.strftime('%Y-%m-%d %H:%M UTC')))
+	print('};')
+
+if __name__ == '__main__':
+	main()